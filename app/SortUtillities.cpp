@@ -6,9 +6,12 @@
 
 // C++ STD headers
 #include <list>
+#include <atomic>
+#include <algorithm>
 #include <thread>
 #include <iostream>
 #include <mutex>
+#include <memory>
 
 // C headers
 #include <cmath>
@@ -16,6 +19,7 @@
 // Unix headers
 #include <unistd.h>
 #include <sys/wait.h>
+#include <sys/stat.h>
 
 // Buffer library
 #include <Buffer/MTFileBufferFetcher.h>
@@ -25,21 +29,34 @@
 
 // Param library
 #include <Parameters/experimentsetup.h>
+#include <Parameters/Calibration.h>
+#include <Parameters/TimeAlignment.h>
+#include <Parameters/GainMatch.h>
 
 // Event library
 #include <Event/Event.h>
+#include <Event/EventBuilder.h>
+#include <Event/iThembaEvent.h>
 
 // ROOT interface library
+#include <RootInterface/FlatTreeWriter.h>
+#include <RootInterface/FlatWriter.h>
 #include <RootInterface/RootFileManager.h>
+#include <RootInterface/RootSettings.h>
+#include <RootInterface/ShardManager.h>
 #include <RootInterface/HistManager.h>
+#include <RootInterface/NTupleManager.h>
 #include <RootInterface/TreeManager.h>
 
 // Utillities
 #include <Utilities/ProgressUI.h>
 #include <Utilities/CLI_interface.h>
+#include <Utilities/ReorderStage.h>
 
 // ROOT headers
 #include <ROOT/TBufferMerger.hxx>
+#include <RVersion.h>
+#include <Compression.h>
 
 #if LOG_ENABLED
 #include <spdlog/spdlog.h>
@@ -54,6 +71,9 @@
 
 extern ProgressUI progress;
 
+#define SPLIT_BATCH_SIZE 4096 //! Max. number of entries the splitter dequeues at once
+#define FLAT_BATCH_SIZE 65536 //! Max. number of entries the flat writer dequeues at once
+
 inline double TimeDiff(const Parser::Entry_t &lhs, const Parser::Entry_t &rhs)
 {
     return double(lhs.timestamp - rhs.timestamp) + (lhs.cfdcorr - rhs.cfdcorr);
@@ -61,23 +81,36 @@ inline double TimeDiff(const Parser::Entry_t &lhs, const Parser::Entry_t &rhs)
 
 // #################################################################
 
-bool Split_entries(const Settings_t *settings, std::vector<Parser::Entry_t> &entries)
+bool Split_entries(const Settings_t *settings, std::vector<Parser::Entry_t> &batch, Event::EventChunk &chunk)
 {
-    Parser::Entry_t entry;
-    if ( !settings->input_queue->wait_dequeue_timed(entry, std::chrono::seconds(1)) )
+    const size_t size = settings->input_queue->wait_dequeue_bulk_timed(batch.begin(), batch.size(),
+                                                                       std::chrono::seconds(1));
+    if ( size == 0 )
         return false;
 
-    if ( entries.empty() ) {
-        entries.push_back(entry);
-    }
-
-    if ( fabs(TimeDiff(entry, entries.back())) < settings->split_time ){
-        entries.push_back(entry);
-    } else {
-        settings->split_queue->enqueue(entries);
-        entries.clear();
-        entries.push_back(entry);
-    }
+    const Parser::Entry_t *entries = batch.data();
+    const double split_time = settings->split_time;
+
+    // The first entry of the batch is compared to the last entry of the current chunk.
+    size_t first = 0;
+    if ( !chunk.entries.empty() && fabs(TimeDiff(entries[0], chunk.entries.back())) >= split_time ){
+        const uint64_t sequence = chunk.sequence;
+        settings->split_queue->enqueue(std::move(chunk));
+        chunk = Event::EventChunk();
+        chunk.sequence = sequence + 1;
+    }
+
+    for ( size_t n = 1 ; n < size ; ++n ){
+        if ( fabs(TimeDiff(entries[n], entries[n-1])) < split_time )
+            continue;
+        chunk.entries.insert(chunk.entries.end(), entries + first, entries + n);
+        const uint64_t sequence = chunk.sequence;
+        settings->split_queue->enqueue(std::move(chunk));
+        chunk = Event::EventChunk();
+        chunk.sequence = sequence + 1;
+        first = n;
+    }
+    chunk.entries.insert(chunk.entries.end(), entries + first, entries + size);
     return true;
 }
 
@@ -85,22 +118,27 @@ bool Split_entries(const Settings_t *settings, std::vector<Parser::Entry_t> &ent
 
 void SpliterThread(const Settings_t *settings, const bool *running)
 {
-    std::vector<Parser::Entry_t> entries;
+    std::vector<Parser::Entry_t> batch(SPLIT_BATCH_SIZE);
+    Event::EventChunk chunk;
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfor-loop-analysis"
     while (*running){
 
-        if ( !Split_entries(settings, entries) ){
+        if ( !Split_entries(settings, batch, chunk) ){
             // Do nothing...
         }
 
     }
 #pragma clang diagnostic pop
 
-    while ( Split_entries(settings, entries) ){
+    while ( Split_entries(settings, batch, chunk) ){
         // Everyting done in function...
     }
+
+    // The last chunk has no gap after it.
+    if ( !chunk.entries.empty() )
+        settings->split_queue->enqueue(std::move(chunk));
 }
 
 // #################################################################
@@ -118,82 +156,91 @@ void RunSplitterThread(const Settings_t *settings, const bool *running)
 
 // #################################################################
 
-bool Make_events(const Settings_t *settings)
+bool Make_events(const Settings_t *settings, ReorderStage *reorder)
 {
-    std::vector<Parser::Entry_t> entries;
-    std::vector<Parser::Entry_t> event;
+    Event::EventChunk chunk;
 
-    if ( !settings->split_queue->wait_dequeue_timed(entries, std::chrono::seconds(1)) )
+    if ( !settings->split_queue->wait_dequeue_timed(chunk, std::chrono::seconds(1)) )
         return false;
 
-    if ( settings->trigger_type == any ) {
-        settings->built_queue->enqueue(entries);
-        return true;
+    // A chunk not fulfilling the condition as a whole can't contain any event that does.
+    const Parser::Entry_t *begin = chunk.entries.data();
+    const Parser::Entry_t *end = begin + chunk.entries.size();
+    if ( settings->condition && !settings->condition->Accept(begin, end) ) {
+        // Nothing to build.
+    } else {
+        Event::EventBuilder builder(settings->trigger_type, settings->event_time, settings->condition);
+        if ( settings->trigger_type == any )
+            builder.BuildWindows(begin, chunk.entries.size(), chunk.events, settings->window_mode);
+        else
+            builder.BuildEvents(begin, chunk.entries.size(), chunk.events);
     }
 
-    auto entry = std::begin(entries);
-
-    while ( entry != std::end(entries) ){
-
-        if ( GetDetectorType((*entry).address) == settings->trigger_type ){
-            auto start = entry;
-            while ( start != std::begin(entries) ){
-                if ( fabs(TimeDiff(*start, *entry)) < settings->event_time ){
-                    --start;
-                } else
-                    break;
-            }
-
-            auto stop = entry+1;
-            while ( stop != std::end(entries) ){
-                if ( fabs(TimeDiff(*stop, *entry)) < settings->event_time ){
-                    ++stop;
-                } else
-                    break;
-            }
-            settings->built_queue->enqueue(std::vector<Parser::Entry_t>(start, stop));
-            entry = stop;
-        } else {
-            ++entry;
-        }
-    }
+    // Chunks without events are also pushed such that the reorder stage doesn't wait for them.
+    reorder->Push(std::move(chunk));
     return true;
 }
 
 // #################################################################
 
-void EventBuilderThread(const Settings_t *settings, const bool *running)
+void EventBuilderThread(const Settings_t *settings, const bool *running, ReorderStage *reorder)
 {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfor-loop-analysis"
-    while ( (*running) ){
-        if ( !Make_events(settings) ) {
+    while ( (*running) && !reorder->Aborted() ){
+        if ( !Make_events(settings, reorder) ) {
             // Do nothing
         }
     }
 #pragma clang diagnostic pop
 
-    while ( Make_events(settings) ){
+    // No point in building more events if another builder has failed.
+    while ( !reorder->Aborted() && Make_events(settings, reorder) ){
         // Everything done in function...
     }
 }
 
 // #################################################################
 
-void RunEventBuilder(const Settings_t *settings, const bool *running)
+void RunEventBuilder(const Settings_t *settings, const bool *running, ReorderStage *reorder)
 {
     try {
-        EventBuilderThread(settings, running);
+        EventBuilderThread(settings, running, reorder);
     } catch (const std::exception &e){
 #if LOG_ENABLED
         spdlog::get("console")->error("Event builder thread got and exception {}", e.what());
 #endif // LOG_ENABLED
+        // The chunk that failed will never reach the reorder stage, the other threads would wait for it forever.
+        std::cerr << "Error: Event building failed, " << e.what() << std::endl;
+        reorder->Abort();
     }
 
 }
 
 // #################################################################
 
+//! Fill the histograms and the tree with all events of a chunk.
+inline void FillEvents(const Settings_t *settings, const Event::EventChunk &chunk, Event::iThembaEvent &evt,
+                       HistManager &histManager, TreeManager &treeManager, NTupleManager *ntupleManager)
+{
+    for ( auto &range : chunk.events ){
+        evt.Fill(chunk.entries.data() + range.begin, chunk.entries.data() + range.end);
+        if ( settings->particles )
+            evt.ReconstructParticles();
+        histManager.AddEntry(evt);
+        if ( settings->addback ){
+            evt.Addback(histManager.GetAB());
+            histManager.AddAddback(evt);
+        }
+        if ( settings->build_tree )
+            treeManager.AddEntry(&evt);
+        if ( ntupleManager )
+            ntupleManager->AddEntry(evt);
+    }
+}
+
+// #################################################################
+
 void RootFillerThread(const Settings_t *settings, const bool *running, const int thread_id)
 {
     char tmp[1024];
@@ -201,34 +248,46 @@ void RootFillerThread(const Settings_t *settings, const bool *running, const int
         sprintf(tmp, "%s_%i", settings->output_file.c_str(), thread_id);
     else
         sprintf(tmp, "%s", settings->output_file.c_str());
-    RootFileManager fileManager(tmp, "RECREATE", settings->file_title.c_str());
-    HistManager histManager(&fileManager);
-    TreeManager treeManager(&fileManager,
-            settings->tree_name.c_str(),
-            settings->tree_title.c_str(),
-            settings->event_type->New());
+    RootFileManager fileManager(tmp, "RECREATE", settings->file_title.c_str(), settings->root->options);
+    HistManager histManager(&fileManager, settings->root->histograms);
+
+    // A sharded tree is written to its own files, the histograms stay in the output file.
+    std::unique_ptr<ShardManager> shardManager( ( IsSharded(settings->root->shards) ) ?
+            new ShardManager(tmp, settings->root->options, settings->root->shards) : nullptr );
+    std::unique_ptr<TreeManager> treeManager;
+    if ( shardManager )
+        treeManager.reset(new TreeManager(shardManager.get(),
+                                          settings->tree_name.c_str(),
+                                          settings->tree_title.c_str(),
+                                          settings->event_type->New(),
+                                          settings->tree_types));
+    else
+        treeManager.reset(new TreeManager(&fileManager,
+                                          settings->tree_name.c_str(),
+                                          settings->tree_title.c_str(),
+                                          settings->event_type->New(),
+                                          settings->tree_types));
+
 
+    std::unique_ptr<NTupleManager> ntupleManager( ( settings->root->ntuple ) ? new NTupleManager(settings->root->ntuple.get()) : nullptr );
 
-    std::vector<Parser::Entry_t> event;
+    // A single event object is reused for all events filled by this thread.
+    Event::iThembaEvent evt;
+    Event::EventChunk chunk;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfor-loop-analysis"
     while ( (*running) ){
 
-        if ( settings->built_queue->wait_dequeue_timed(event, std::chrono::seconds(1)) ){
-            Event::iThembaEvent evt(event);
-            histManager.AddEntry(evt);
-            if ( settings->build_tree )
-                treeManager.AddEntry(&evt);
+        if ( settings->built_queue->wait_dequeue_timed(chunk, std::chrono::seconds(1)) ){
+            FillEvents(settings, chunk, evt, histManager, *treeManager, ntupleManager.get());
         }
     }
 #pragma clang diagnostic pop
 
-    while ( settings->built_queue->try_dequeue(event) ){
-        Event::iThembaEvent evt(event);
-        histManager.AddEntry(evt);
-        if ( settings->build_tree )
-            treeManager.AddEntry(&evt);
+    while ( settings->built_queue->try_dequeue(chunk) ){
+        FillEvents(settings, chunk, evt, histManager, *treeManager, ntupleManager.get());
     }
+    histManager.Flush();
 }
 
 // #################################################################
@@ -237,38 +296,39 @@ void RootFillerThread(const Settings_t *settings, const bool *running, const int
 #pragma clang diagnostic ignored "-Wfor-loop-analysis"
 void RFT(const Settings_t *settings, const bool *running, ROOT::Experimental::TBufferMerger *fm)
 {
-    RootMergeFileManager fileManager(fm);
-    HistManager histManager(&fileManager);
+    RootMergeFileManager fileManager(fm, settings->root->options);
+    HistManager histManager(&fileManager, settings->root->histograms);
     TreeManager treeManager(&fileManager,
                             settings->tree_name.c_str(),
                             settings->tree_title.c_str(),
-                            settings->event_type->New());
+                            settings->event_type->New(),
+                            settings->tree_types);
 
 
-    std::vector<Parser::Entry_t> event;
+    std::unique_ptr<NTupleManager> ntupleManager( ( settings->root->ntuple ) ? new NTupleManager(settings->root->ntuple.get()) : nullptr );
+
+    // A single event object is reused for all events filled by this thread.
+    Event::iThembaEvent evt;
+    Event::EventChunk chunk;
 
     while ( (*running) ){
 
-        if ( settings->built_queue->wait_dequeue_timed(event, std::chrono::seconds(1)) ){
-            Event::iThembaEvent evt(event);
-            histManager.AddEntry(evt);
-            if ( settings->build_tree )
-                treeManager.AddEntry(&evt);
+        if ( settings->built_queue->wait_dequeue_timed(chunk, std::chrono::seconds(1)) ){
+            FillEvents(settings, chunk, evt, histManager, treeManager, ntupleManager.get());
         }
     }
 
-    while ( settings->built_queue->try_dequeue(event) ){
-        Event::iThembaEvent evt(event);
-        histManager.AddEntry(evt);
-        if ( settings->build_tree )
-            treeManager.AddEntry(&evt);
+    while ( settings->built_queue->try_dequeue(chunk) ){
+        FillEvents(settings, chunk, evt, histManager, treeManager, ntupleManager.get());
     }
+    histManager.Flush();
 }
 #pragma clang diagnostic pop
 
 // #################################################################
 
-void RunRootThread(const Settings_t *settings, const bool *running, ROOT::Experimental::TBufferMerger *fm)
+void RunRootThread(const Settings_t *settings, const bool *running, ROOT::Experimental::TBufferMerger *fm,
+                   std::atomic<bool> *failed)
 {
     try {
         RFT(settings, running, fm);
@@ -276,6 +336,9 @@ void RunRootThread(const Settings_t *settings, const bool *running, ROOT::Experi
 #if LOG_ENABLED
         spdlog::get("console")->error("ROOT filler thread got and exception {}", e.what());
 #endif // LOG_ENABLED
+        // The events taken by this thread are lost, and if no filler is left the built events are never consumed.
+        std::cerr << "Error: Filling the output failed, " << e.what() << std::endl;
+        *failed = true;
     }
 }
 #endif // ROOT_MT_FLAG
@@ -348,6 +411,40 @@ void WriteCSV(const Settings_t *settings, const bool *running)
 
 // #################################################################
 
+void FlatWrite(const Settings_t *settings, const bool *running, FlatWriter *writer)
+{
+    std::vector<Parser::Entry_t> batch(FLAT_BATCH_SIZE);
+    size_t size;
+
+    while ( (*running) ){
+        size = settings->input_queue->wait_dequeue_bulk_timed(batch.begin(), batch.size(), std::chrono::seconds(1));
+        if ( size > 0 )
+            writer->Write(batch.data(), size);
+    }
+
+    while ( (size = settings->input_queue->try_dequeue_bulk(batch.begin(), batch.size())) > 0 ){
+        writer->Write(batch.data(), size);
+    }
+}
+
+// #################################################################
+
+void WriteFlat(const Settings_t *settings, const bool *running, FlatWriter *writer, std::atomic<bool> *failed)
+{
+    try {
+        FlatWrite(settings, running, writer);
+    } catch (const std::exception &e){
+#if LOG_ENABLED
+        spdlog::get("console")->error("Flat writer got an exception {}", e.what());
+#endif // LOG_ENABLED
+        // The writer is the only consumer of the input queue, the main thread would wait for it forever.
+        std::cerr << "Error: Writing the output failed, " << e.what() << std::endl;
+        *failed = true;
+    }
+}
+
+// #################################################################
+
 void GetEnumType(char *str, const DetectorInfo_t &dinfo)
 {
     switch ( dinfo.type ) {
@@ -505,6 +602,106 @@ void ConvertPostgre(const Settings_t *settings)
 }
 #endif // POSTGRESQL_ENABLED
 
+size_t BuffersToSample(const std::string &fname, const Fetcher::Buffer *buffer, const double &fraction)
+{
+    // For gzip'ed files this is an estimate based on the compressed size.
+    struct stat s{};
+    if ( stat(fname.c_str(), &s) < 0 )
+        return 0;
+    auto nbuffers = size_t(s.st_size)/buffer->GetSizeChar();
+    return std::max(size_t(fraction*nbuffers), size_t(1));
+}
+
+void AlignTime(const Settings_t *settings, const char *calfile, const double &fraction,
+               const DetectorType &ref_type, const int &ref_num)
+{
+    Fetcher::FileBufferFetcher *bf = new Fetcher::MTFileBufferFetcher(settings->buffer_type);
+    const Fetcher::Buffer *buf;
+    std::vector<Parser::Entry_t> entries;
+    TimeAlignment alignment(settings->event_time, ref_type, ref_num);
+
+    for ( auto &file : settings->input_files ){
+        size_t nbuffers = BuffersToSample(file, settings->buffer_type, fraction);
+        Fetcher::BufferFetcher::Status status = bf->Open(file.c_str(), 0);
+
+        for ( size_t n = 0 ; n < nbuffers ; ++n ){
+            buf = bf->Next(status);
+            if ( status != Fetcher::BufferFetcher::OKAY ){
+                break;
+            }
+            entries = settings->parser->GetEntry(buf);
+            alignment.Fill(entries);
+        }
+    }
+    delete bf;
+
+    // Only part of each file is read, the reading progress of the last file is left as is.
+    std::cout << std::endl << "Aligned " << alignment.Solve() << " channels." << std::endl;
+    if ( WriteCalibration(calfile) )
+        std::cout << "Time alignment written to '" << calfile << "'" << std::endl;
+}
+
+void MatchGains(const Settings_t *settings, const char *calfile, const size_t &nbuffers,
+                const std::vector<double> &lines, const int &reference)
+{
+    Fetcher::FileBufferFetcher *bf = new Fetcher::MTFileBufferFetcher(settings->buffer_type);
+    const Fetcher::Buffer *buf;
+    std::vector<Parser::Entry_t> entries;
+    GainMatch gainMatch(lines, reference);
+
+    size_t nread = 0;
+    for ( auto &file : settings->input_files ){
+        Fetcher::BufferFetcher::Status status = bf->Open(file.c_str(), 0);
+
+        while ( nread < nbuffers ){
+            buf = bf->Next(status);
+            if ( status != Fetcher::BufferFetcher::OKAY ){
+                break;
+            }
+            entries = settings->parser->GetEntry(buf);
+            gainMatch.Fill(entries);
+            ++nread;
+        }
+        if ( nread >= nbuffers )
+            break;
+    }
+    delete bf;
+
+    // Only the first buffers are read, the reading progress of the last file is left as is.
+    std::cout << std::endl << "Gain matched " << gainMatch.Solve() << " channels." << std::endl;
+    if ( WriteCalibration(calfile) )
+        std::cout << "Energy calibration written to '" << calfile << "'" << std::endl;
+}
+
+unsigned ScanDetectorTypes(const Settings_t *settings, const size_t &nbuffers)
+{
+    Fetcher::FileBufferFetcher *bf = new Fetcher::MTFileBufferFetcher(settings->buffer_type);
+    const Fetcher::Buffer *buf;
+    std::vector<Parser::Entry_t> entries;
+    unsigned types = 0;
+
+    // Each file is scanned, a detector may only be connected for some of the runs.
+    for ( auto &file : settings->input_files ){
+        Fetcher::BufferFetcher::Status status = bf->Open(file.c_str(), 0);
+
+        for ( size_t nread = 0 ; nread < nbuffers ; ++nread ){
+            buf = bf->Next(status);
+            if ( status != Fetcher::BufferFetcher::OKAY ){
+                break;
+            }
+            entries = settings->parser->GetEntry(buf);
+            for ( auto &entry : entries ){
+                types |= 1u << GetDetectorType(entry.address);
+            }
+        }
+    }
+    delete bf;
+
+    // The conversion has to start from the first buffer without any state from the scan.
+    settings->parser->Reset();
+    return types;
+}
+
 void ConvertFilesCSV(const Settings_t *settings)
 {
     Fetcher::FileBufferFetcher *bf = new Fetcher::MTFileBufferFetcher(settings->buffer_type);
@@ -566,6 +763,63 @@ void ConvertFilesCSV(const Settings_t *settings)
 
 }
 
+void ConvertFilesFlat(const Settings_t *settings)
+{
+    Fetcher::FileBufferFetcher *bf = new Fetcher::MTFileBufferFetcher(settings->buffer_type);
+    const Fetcher::Buffer *buf;
+    std::vector<Parser::Entry_t> entries;
+
+    // The hits goes straight from the parser to the writer, there is only one writer to keep the time order.
+    std::unique_ptr<RootFileManager> fileManager;
+    std::unique_ptr<FlatWriter> writer;
+    if ( settings->flat_output == FlatOutput::tree ){
+        fileManager.reset(new RootFileManager(settings->output_file.c_str(), "RECREATE",
+                                              settings->file_title.c_str(), settings->root->options));
+        writer.reset(new FlatTreeWriter(fileManager.get(), settings->tree_name.c_str(), settings->tree_title.c_str()));
+    } else {
+        writer.reset(new FlatBinaryWriter(settings->output_file.c_str()));
+    }
+
+    bool writer_running = true;
+    std::atomic<bool> writer_failed(false);
+    std::thread writer_thread(WriteFlat, settings, &writer_running, writer.get(), &writer_failed);
+
+    for ( auto &file : settings->input_files ){
+        Fetcher::BufferFetcher::Status status = bf->Open(file.c_str(), 0);
+
+        while ( !writer_failed ){
+            buf = bf->Next(status);
+            if ( status != Fetcher::BufferFetcher::OKAY ){
+                break;
+            }
+            entries = settings->parser->GetEntry(buf);
+            settings->input_queue->enqueue_bulk(std::begin(entries), entries.size());
+        }
+    }
+
+    writer_running = false;
+
+    auto approx_start_size = settings->input_queue->size_approx();
+    progress.StartFillingTree(approx_start_size);
+    size_t current_size;
+    while ( settings->input_queue->size_approx() > 1000 && !writer_failed ){
+        current_size = settings->input_queue->size_approx();
+        progress.UpdateTreeFillProgress(approx_start_size - current_size);
+        std::this_thread::sleep_for(std::chrono::microseconds(250));
+    }
+    progress.Finish();
+
+    if ( writer_thread.joinable() )
+        writer_thread.join();
+
+    // Closes the column files or writes the tree to disk.
+    writer.reset();
+    delete bf;
+
+    if ( writer_failed )
+        throw std::runtime_error("Writing the output failed, the output is incomplete");
+}
+
 void ConvertFiles(const Settings_t *settings)
 {
     // First we will setup all the required file fetchers, etc.
@@ -577,25 +831,43 @@ void ConvertFiles(const Settings_t *settings)
     bool splitter_running = true;
     bool builder_running = true;
     bool filler_running = true;
+    std::atomic<bool> filler_failed(false);
 
+#if ROOT_MT_FLAG
+    // Each filler thread fills its own trees and histograms, merged into the output file.
+    // A sharded tree is filled by a single thread, such that the shards are in time order.
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,18,0)
+    const int default_compression = ROOT::RCompressionSetting::EDefaults::kUseGeneralPurpose;
+#else
+    const int default_compression = 1;
+#endif // ROOT_VERSION_CODE
+    const bool merge = !IsSharded(settings->root->shards);
+    std::unique_ptr<ROOT::Experimental::TBufferMerger> bufferMerger( ( merge ) ?
+            new ROOT::Experimental::TBufferMerger(settings->output_file.c_str(), "RECREATE",
+                    ( settings->root->options.compression >= 0 ) ? settings->root->options.compression : default_compression) : nullptr );
+#endif // ROOT_MT_FLAG
 
-    ROOT::Experimental::TBufferMerger bufferMerger(settings->output_file.c_str(), "RECREATE");
+    // Chunks are built in parallel, the reorder stage puts them back in order before filling.
+    ReorderStage reorder(settings->built_queue, 4*settings->num_split_threads);
 
     std::thread split_thread(SpliterThread, settings, &splitter_running);
     std::list<std::thread> event_threads(settings->num_split_threads);
 #if ROOT_MT_FLAG
-    std::list<std::thread> fill_threads(settings->num_filler_threads);
+    std::list<std::thread> fill_threads( ( merge ) ? settings->num_filler_threads : 1 );
 #else
     std::list<std::thread> fill_threads(1);
 #endif // ROOT_MT_FLAG
 
     for ( auto &thread : event_threads ){
-        thread = std::thread(EventBuilderThread, settings, &builder_running);
+        thread = std::thread(RunEventBuilder, settings, &builder_running, &reorder);
     }
 
     for ( auto &thread : fill_threads ){
 #if ROOT_MT_FLAG
-        thread = std::thread(RFT, settings, &filler_running, &bufferMerger);
+        if ( merge )
+            thread = std::thread(RunRootThread, settings, &filler_running, bufferMerger.get(), &filler_failed);
+        else
+            thread = std::thread(RootFillerThread, settings, &filler_running, -1);
 #else
         thread = std::thread(RootFillerThread, settings, &filler_running, -1);
 #endif // ROOT_MT_FLAG
@@ -628,7 +900,7 @@ void ConvertFiles(const Settings_t *settings)
 
     size_t approx_start_size = settings->split_queue->size_approx();
     progress.StartBuildingEvents(approx_start_size);
-    while ( settings->split_queue->size_approx() > 1000 ){
+    while ( settings->split_queue->size_approx() > 1000 && !reorder.Aborted() ){
         progress.UpdateEventBuildingProgress(approx_start_size - settings->split_queue->size_approx());
         std::this_thread::sleep_for(std::chrono::microseconds(250));
     }
@@ -646,7 +918,7 @@ void ConvertFiles(const Settings_t *settings)
     approx_start_size = settings->built_queue->size_approx();
     progress.StartFillingTree(approx_start_size);
     size_t current_size;
-    while ( settings->built_queue->size_approx() > 1000 ){
+    while ( settings->built_queue->size_approx() > 1000 && !filler_failed ){
         current_size = settings->built_queue->size_approx();
         progress.UpdateTreeFillProgress(approx_start_size - current_size);
         std::this_thread::sleep_for(std::chrono::microseconds(250));
@@ -660,4 +932,9 @@ void ConvertFiles(const Settings_t *settings)
         }
     }
     std::cout << " Done" << std::endl;
+
+    if ( reorder.Aborted() )
+        throw std::runtime_error("Event building failed, the output is incomplete");
+    if ( filler_failed )
+        throw std::runtime_error("Filling the output failed, the output is incomplete");
 }
\ No newline at end of file
@@ -13,16 +13,18 @@
 
 // Utillities library
 #include <Utilities/CLI_interface.h>
+#include <Utilities/ReorderStage.h>
 
 
 
 /*!
  * Function implementing the list splitter logic
  * \param settings Settings structure containing the input parameters from the user
- * \param entries buffer with the entries
+ * \param batch buffer the entries are dequeued into, its size sets the max. number of entries dequeued at once
+ * \param chunk chunk being filled with entries, gets the next sequence number when queued
  * \return True if entries are found and filled into the queue, False otherwise
  */
-bool Split_entries(const Settings_t *settings, std::vector<Parser::Entry_t> &entries);
+bool Split_entries(const Settings_t *settings, std::vector<Parser::Entry_t> &batch, Event::EventChunk &chunk);
 
 /*!
  * Entry point for the splitter thread
@@ -34,16 +36,18 @@ void SpliterThread(const Settings_t *settings, const bool *running);
 /*!
  * Function implementing the actual event building logic
  * \param settings Settings structure containing the input parameters from the user
+ * \param reorder stage restoring the order of the chunks before filling
  * \return True if any data was found in the queue, false otherwise.
  */
-bool Make_events(const Settings_t *settings);
+bool Make_events(const Settings_t *settings, ReorderStage *reorder);
 
 /*!
  * Entry point for the event builder thread
  * \param settings Settings structure containing the input parameters from the user
  * \param running flag to indicate that the last buffer from files have been filled in the input queue
+ * \param reorder stage restoring the order of the chunks before filling
  */
-void EventBuilderThread(const Settings_t *settings, const bool *running);
+void EventBuilderThread(const Settings_t *settings, const bool *running, ReorderStage *reorder);
 
 /*!
  * Entry point for the ROOT file filler thread
@@ -55,11 +59,50 @@ void RootFillerThread(const Settings_t *settings, const bool *running, int threa
 /*!
  * Implementation of the file conversion loop
  * \param settings Settings structure containing the input parameters from the user
+ * \throws std::runtime_error if any of the event builder or filler threads failed
  */
 void ConvertFiles(const Settings_t *settings);
 
+/*!
+ * Pre-pass finding the time alignment of all detectors from a sample of the run.
+ * \param settings Settings structure containing the input parameters from the user
+ * \param calfile Calibration file to write with the updated time alignment
+ * \param fraction Fraction of the buffers of each input file to process
+ * \param ref_type Detector type of the reference detector
+ * \param ref_num Detector number of the reference detector
+ * \throws std::runtime_error if the reference detector had no entries in the sample
+ */
+void AlignTime(const Settings_t *settings, const char *calfile, const double &fraction,
+               const DetectorType &ref_type, const int &ref_num);
+
+/*!
+ * Pre-pass gain matching all detectors from the first buffers of the run.
+ * \param settings Settings structure containing the input parameters from the user
+ * \param calfile Calibration file to write with the updated gain and shift values
+ * \param nbuffers Number of buffers to process
+ * \param lines Known source lines [keV], if empty channels are matched to a reference channel
+ * \param reference Reference channel of each detector type
+ */
+void MatchGains(const Settings_t *settings, const char *calfile, const size_t &nbuffers,
+                const std::vector<double> &lines, const int &reference);
+
+/*!
+ * Pre-pass finding the detector types present in the data.
+ * \param settings Settings structure containing the input parameters from the user
+ * \param nbuffers Number of buffers to scan at the start of each input file
+ * \return Mask with bit n set if an entry of detector type n was seen
+ */
+unsigned ScanDetectorTypes(const Settings_t *settings, const size_t &nbuffers);
+
 void ConvertPostgre(const Settings_t *settings);
 
 void ConvertFilesCSV(const Settings_t *settings);
 
+/*!
+ * Write the calibrated hits as flat columns, without building events.
+ * \param settings Settings structure containing the input parameters from the user
+ * \throws std::runtime_error if the writer failed
+ */
+void ConvertFilesFlat(const Settings_t *settings);
+
 #endif // SORTUTILLITIES_H
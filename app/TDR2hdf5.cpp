@@ -7,6 +7,7 @@
 #include <map>
 #include <thread>
 #include <exception>
+#include <memory>
 
 #include <spdlog/spdlog.h>
 #include <CLI/CLI.hpp>
@@ -31,36 +32,6 @@ struct RunSettings {
     bool addback{false};
 };
 
-size_t CountTDREvents(const std::vector<std::string> &files)
-{
-    auto buffer_type = Fetcher::TDRBuffer();
-    auto *bf = new Fetcher::MTFileBufferFetcher(&buffer_type);
-    auto parser = Parser::TDRparser();
-    const Fetcher::Buffer *buf;
-    std::vector<Parser::Entry_t> entries;
-    size_t eventsFound = 0;
-
-
-    for (auto &file : files){
-        auto status = bf->Open(file.c_str(), 0);
-        if (status != Fetcher::BufferFetcher::OKAY){
-            throw std::runtime_error("Unable to read file '" + file + "'.");
-        }
-
-        while (true){
-            buf = bf->Next(status);
-            if ( status != Fetcher::BufferFetcher::OKAY ){
-                break;
-            }
-            eventsFound += parser.GetEntry(buf).size();
-        }
-    }
-    delete bf;
-    return eventsFound;
-}
-
-
-
 void SetupCLI(CLI::App &app, RunSettings *settings)
 {
     app.description("TDR2HDF5 - A tool to convert TDR files to HDF5 files.");
@@ -80,7 +51,7 @@ void SetupCLI(CLI::App &app, RunSettings *settings)
                    settings->threads)->default_val(std::thread::hardware_concurrency());
 
     app.add_flag("-a,--addback", settings->addback,
-                 "Turn addback on or off")->default_val(true);
+                 "Not supported, addback needs built events while the hits are written as they are");
 }
 
 
@@ -97,16 +68,18 @@ int main(int argc, char* argv[])
         return app.exit(e);
     }
 
-    // Next we will need to get the total number of events in the input file.
-    size_t nEvents = CountTDREvents(settings.input_files);
-
-    // Now we setup the file writer
-    HDF5_Writer writer;
+    if ( settings.addback ){
+        spdlog::error("Addback requires built events, use TDR2tree. TDR2hdf5 writes the hits without building events.");
+        return 1;
+    }
 
+    // Each file is parsed once, the datasets grow as the entries are written.
+    std::unique_ptr<HDF5_Writer> writer;
     try {
-        writer.allocate(settings.output_file.c_str(), nEvents);
+        writer.reset(new HDF5_Writer(settings.output_file.c_str()));
     } catch (std::exception &e) {
-        spdlog::error("Creating output file failed. Error %s", e.what());
+        spdlog::error("Creating output file failed. Error {}", e.what());
+        return 1;
     }
 
     // Read and write to file
@@ -127,13 +100,11 @@ int main(int argc, char* argv[])
                 break;
             }
             entries = parser.GetEntry(buf);
-            for ( auto &entry : entries ){
-                if (!writer.Write(entry))
-                    break;
-            }
+            writer->Write(entries.data(), entries.size());
         }
     }
-    delete buf;
+    delete bf;
 
+    writer.reset();
     return 0;
-}
\ No newline at end of file
+}
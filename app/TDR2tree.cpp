@@ -4,6 +4,7 @@
 
 // C++ STD libs
 #include <iostream>
+#include <stdexcept>
 
 // C libs
 #include <cstdio>
@@ -33,6 +34,7 @@
 
 ProgressUI progress; // NOLINT(cert-err58-cpp)
 
+#include <RootInterface/RootSettings.h>
 #include <Utilities/CLI_interface.h>
 #include <CLI/CLI.hpp>
 
@@ -50,14 +52,19 @@ void SetupTDR(Settings_t &settings, const int &queue_size)
     settings.parser = new Parser::TDRparser;
     settings.event_type = new Event::iThembaEvent;
     settings.input_queue = new Entry_queue_t(queue_size);
-    settings.split_queue = new Event_queue_t(queue_size);
-    settings.built_queue = new Event_queue_t(queue_size);
+    settings.split_queue = new Chunk_queue_t(queue_size);
+    settings.built_queue = new Chunk_queue_t(queue_size);
     settings.str_queue = new String_queue_t(queue_size);
 
     if ( settings.build_tree && settings.output_csv ){
         std::cerr << "Error: Cannot output CSV and tree at the same time." << std::endl;
         exit(EXIT_FAILURE);
     }
+
+    if ( settings.flat_output != FlatOutput::none && (settings.build_tree || settings.output_csv) ){
+        std::cerr << "Error: Flat output cannot be combined with tree or CSV output." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 }
 
 int main(int argc, char* argv[])
@@ -69,29 +76,28 @@ int main(int argc, char* argv[])
     file_logger->set_level(spdlog::level::info);
 #endif // LOG_ENABLED
 
-    Settings_t settings = {
-            std::vector<std::string>(),
-            "",
-            "TDR2tree",
-            false,
-            false,
-            "events",
-            "Events",
-            nullptr,
-            nullptr,
-            nullptr,
-            1500,
-            1500,
-            DetectorType::eDet,
-            nullptr,
-            nullptr,
-            nullptr,
-            nullptr,
-            2,
-            1
-    };
+    // The ROOT output settings are kept apart, such that the Utilities don't depend on the RootInterface.
+    RootSettings_t root_settings;
+    Settings_t settings;
+    settings.root = &root_settings;
 
+    std::string condition = "";
+    std::string histfile = "";
+    std::string compression = "";
+    std::string ntuple_file = "";
     std::string config_out = "";
+    std::string align_out = "";
+    double sample_fraction = 0.1;
+    DetectorType align_type = labr_2x2_fs;
+    int align_reference = 0;
+    std::string gain_out = "";
+    size_t gain_buffers = 1000;
+    std::vector<double> gain_lines;
+    int gain_reference = 0;
+    bool sparse = false;
+    double shard_size = 0;
+    double shard_time = 0;
+    size_t sparse_buffers = 0;
 
     CLI::App app{"TDR2tree - a list-mode converter and event builder"};
 
@@ -113,6 +119,16 @@ int main(int argc, char* argv[])
         {"unused", DetectorType::unused}
     };
 
+    std::vector<std::pair<std::string, Event::WindowMode> > window_map{
+        {"fixed", Event::WindowMode::fixed_window},
+        {"gap", Event::WindowMode::gap_window}
+    };
+
+    std::vector<std::pair<std::string, FlatOutput> > flat_map{
+        {"tree", FlatOutput::tree},
+        {"binary", FlatOutput::binary}
+    };
+
     size_t Queue_size = 0x2000;
 
     app.add_option("-i,--input", settings.input_files, "Input file(s)")->required();
@@ -121,23 +137,90 @@ int main(int argc, char* argv[])
     app.add_option("-s,--SplitTime", settings.split_time,
             "Time gap between entries where data are split. Default is 1500 ns")->default_val("1500");
     app.add_option("-e,--EventTime", settings.event_time,
-            "Maximum time difference for an entry to be included in an event. Default is 1500 ns")->default_val("1500");
+            "Maximum time difference for an entry to be included in an event. Default is 1500 ns")->default_val("1500")
+        ->check(CLI::PositiveNumber);
     app.add_flag("-t,--tree", settings.build_tree, "Flag to indicate that a tree should be built");
     app.add_flag("--csv", settings.output_csv, "Flag to indicate that output should be compressed CSV (zlib). Cannot be selected together with -t,--tree");
+    app.add_option("--flat", settings.flat_output,
+            "Write the calibrated hits as flat columns without building events. 'tree' writes a tree with one "
+            "branch per column, 'binary' writes one raw file per column named after the output file")
+        ->transform(CLI::CheckedTransformer(flat_map, CLI::ignore_case));
     app.add_option("--TreeName", settings.tree_name, "Name of the tree. Default is 'events'")->default_str("events");
     app.add_option("--TreeTitle", settings.tree_title, "Title of the tree. Default is 'Events'")->default_str("Events");
+    app.add_flag("--sparse", sparse,
+            "Only create branches for the detector types in the address map");
+    app.add_option("--sparse-scan", sparse_buffers,
+            "Only create branches for the detector types seen in this number of buffers at the start of the run");
+    app.add_option("--shard-events", root_settings.shards.events,
+            "Split the tree into a new file every this many events. Default is no splitting");
+    app.add_option("--shard-size", shard_size,
+            "Split the tree into a new file every this many GB (compressed). Default is no splitting");
+    app.add_option("--shard-time", shard_time,
+            "Split the tree into a new file every this many minutes of beam time. Default is no splitting");
+    app.add_option("--compression", compression,
+            "Compression of the ROOT file, an algorithm (zlib, lzma, lz4, zstd, none) and an optional level, e.g. 'lz4' or 'zstd:7'. Default is the ROOT default");
+    app.add_option("--basket-size", root_settings.options.basket_size,
+            "Basket size of the tree branches [bytes]. Default is the ROOT default");
+    app.add_option("--autoflush", root_settings.options.autoflush,
+            "Auto flush of the tree, entries if positive and bytes if negative. Default is the ROOT default");
+    app.add_option("--energy-bits", root_settings.options.storage.energy_bits,
+            "Precision of the stored energies. 0 stores doubles, 32 floats and 2-14 keeps that many mantissa bits. Default is 0");
+    app.add_option("--tfine-bits", root_settings.options.storage.tfine_bits,
+            "Store the fine times as fixed point numbers with this many bits (2-32), 0 stores doubles. Default is 0");
+    app.add_option("--tfine-range", root_settings.options.storage.tfine_range,
+            "Fixed point fine times cover [-range, range) ns, values outside are clamped. Default is 128");
+    app.add_flag("--tcoarse-delta", root_settings.options.storage.tcoarse_delta,
+            "Store the timestamps as 32 bit differences to the first entry of the event, given by the eventTime branch");
+    app.add_option("--autosave", root_settings.options.autosave,
+            "Auto save of the tree, entries if positive and bytes if negative. Default is the ROOT default");
+#if ROOT_NTUPLE_FLAG
+    app.add_option("--ntuple", ntuple_file, "Write the events to an RNTuple in this file");
+#endif // ROOT_NTUPLE_FLAG
     app.add_option("-f,--format", format, "Input file format. Default TDR.")
         ->default_str("TDR")->transform(CLI::CheckedTransformer(format_map, CLI::ignore_case));
     app.add_option("--trigger", settings.trigger_type, "Detector event trigger. Default is eDet")
         ->default_str("eDet")->transform(CLI::CheckedTransformer(trigger_map, CLI::ignore_case));
+    app.add_option("--window", settings.window_mode,
+            "Event windows when the trigger is 'any'. 'fixed' cuts windows of EventTime length, "
+            "'gap' closes a window when the time to the next entry is more than EventTime, "
+            "requires EventTime shorter than SplitTime. Default is fixed")
+        ->default_str("fixed")->transform(CLI::CheckedTransformer(window_map, CLI::ignore_case));
+    app.add_option("--condition", condition,
+            "Coincidence condition events has to fulfill, e.g. 'de_ring & (labr_3x8 | clover>=2)'");
+    app.add_flag("--addback", settings.addback,
+            "Flag to indicate that clover addback should be done. Fills both singles and addback spectra, the tree gets the addback hits");
+    app.add_flag("--particles", settings.particles,
+            "Flag to indicate that dE-E particle hits should be reconstructed. Requires the particle_time_gate and uses the angle_ring calibration");
+    app.add_option("--histograms", histfile,
+            "File with the definitions of the spectra to fill. Default is the built-in set of time and energy spectra");
     app.add_option("--queue_size", Queue_size, "Maximum size of the internal queues. Default is 8192")
         ->default_val("8192");
-    app.add_option("--SplitThreads", settings.num_split_threads, "Number of splitter threads. Default is 1")
+    app.add_option("--SplitThreads", settings.num_split_threads, "Number of event builder threads. Events are filled in time order regardless. Default is 1")
         ->default_val("1");
     app.add_option("--FillThreads", settings.num_filler_threads,
             "Number of filler threads. Default is 1. Note that ROOT often causes errors when multiple threads tries to interact with ROOT")
         ->default_val("1");
     app.add_option("--write-config", config_out, "File to write config to.");
+    app.add_option("--align-time", align_out,
+            "Run a time alignment pre-pass and write the calibration with updated shift_t_* values to this file");
+    app.add_option("--align-reference-type", align_type, "Detector type of the time alignment reference. Default is labr_2x2_fs")
+        ->default_str("labr_2x2_fs")->transform(CLI::CheckedTransformer(trigger_map, CLI::ignore_case));
+    app.add_option("--align-reference", align_reference,
+            "Detector number of the time alignment reference. Default is 0")
+        ->default_val("0")->check(CLI::NonNegativeNumber);
+    app.add_option("--sample-fraction", sample_fraction,
+            "Fraction of each input file to process in calibration pre-passes. Default is 0.1")
+        ->default_val("0.1")->check(CLI::Range(0.0, 1.0));
+    app.add_option("--gain-match", gain_out,
+            "Run a gain matching pre-pass and write the calibration with updated gain_*/shift_* values to this file");
+    app.add_option("--gain-buffers", gain_buffers,
+            "Number of buffers at the start of the run to use for gain matching. Default is 1000")
+        ->default_val("1000");
+    app.add_option("--gain-lines", gain_lines,
+            "Known source lines [keV] to gain match against. If not given, channels are matched to the reference channel");
+    app.add_option("--gain-reference", gain_reference,
+            "Reference channel of each detector type used for gain matching. Default is 0")
+        ->default_val("0")->check(CLI::NonNegativeNumber);
     app.set_config("--config");
     app.config_formatter(std::make_shared<CLI::ConfigTOML>());
     try {
@@ -153,6 +236,10 @@ int main(int argc, char* argv[])
     }
 
     SetCalibration(calfile.c_str());
+    if ( settings.particles && !HasTimeGateParticle() ){
+        std::cerr << "Error: --particles requires a particle_time_gate in the calibration file" << std::endl;
+        return EXIT_FAILURE;
+    }
 
     if ( !config_out.empty() ){
         std::ofstream outfile(config_out);
@@ -164,6 +251,65 @@ int main(int argc, char* argv[])
             [&settings](const std::pair<std::string, DetectorType> &i){
         return i.second == settings.trigger_type; });
     std::cout << "Trigger: " << trig->first << std::endl;
+    if ( settings.trigger_type == any ){
+        // The entries are split at gaps of SplitTime, a gap window would never close within a chunk.
+        if ( settings.window_mode == Event::WindowMode::gap_window && settings.event_time >= settings.split_time ){
+            std::cerr << "Error: --window gap requires an EventTime shorter than the SplitTime" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Event window: ";
+        std::cout << ( ( settings.window_mode == Event::WindowMode::fixed_window ) ? "fixed" : "gap" ) << std::endl;
+    }
+
+    if ( !condition.empty() ){
+        try {
+            settings.condition = new Event::TriggerCondition(condition);
+        } catch ( const std::invalid_argument &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Condition: " << condition << std::endl;
+    }
+
+    if ( !compression.empty() ){
+        try {
+            root_settings.options.compression = ParseCompression(compression);
+        } catch ( const std::invalid_argument &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Compression: " << compression << " (" << root_settings.options.compression << ")" << std::endl;
+    }
+
+    root_settings.shards.bytes = static_cast<long long>(shard_size*1e9);
+    root_settings.shards.time = static_cast<int64_t>(shard_time*60e9);
+
+    try {
+        Event::CheckStorage(root_settings.options.storage);
+    } catch ( const std::invalid_argument &e ){
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ( !ntuple_file.empty() ){
+        try {
+            root_settings.ntuple.reset(new NTupleWriter(ntuple_file.c_str(), settings.tree_name.c_str(), root_settings.options, settings.particles));
+        } catch ( const std::exception &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "RNTuple file: " << ntuple_file << std::endl;
+    }
+
+    if ( !histfile.empty() ){
+        try {
+            root_settings.histograms = ReadHistograms(histfile.c_str());
+        } catch ( const std::runtime_error &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Histogram definitions: " << histfile << " (" << root_settings.histograms.size() << " spectra)" << std::endl;
+    }
 
     std::cout << "Splitter threads: " << settings.num_split_threads << std::endl;
     std::cout << "Filler threads: " << settings.num_filler_threads << std::endl;
@@ -198,6 +344,10 @@ int main(int argc, char* argv[])
     std::cout << "Ouput format: ";
     if ( settings.output_csv )
         std::cout << " CSV" << std::endl;
+    else if ( settings.flat_output == FlatOutput::binary )
+        std::cout << " flat binary columns" << std::endl;
+    else if ( settings.flat_output == FlatOutput::tree )
+        std::cout << " flat ROOT" << std::endl;
     else
         std::cout << " ROOT" << std::endl;
     std::cout << "Output file: " << settings.output_file << std::endl;
@@ -208,14 +358,49 @@ int main(int argc, char* argv[])
     std::cout << "INFO: FillThread flag ignored, single thread filler used." << std::endl;
 #endif // ROOT_MT_FLAG
 
+    if ( !align_out.empty() ){
+        try {
+            AlignTime(&settings, align_out.c_str(), sample_fraction, align_type, align_reference);
+        } catch ( const std::runtime_error &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return 0;
+    }
+
+    if ( !gain_out.empty() ){
+        MatchGains(&settings, gain_out.c_str(), gain_buffers, gain_lines, gain_reference);
+        return 0;
+    }
+
+    if ( sparse_buffers > 0 )
+        settings.tree_types = ScanDetectorTypes(&settings, sparse_buffers);
+    else if ( sparse )
+        settings.tree_types = GetPresentTypes();
+
+    // The particle branches are only made when the particles are reconstructed.
+    if ( settings.particles )
+        settings.tree_types |= 1u << any;
+    else
+        settings.tree_types &= ~(1u << any);
+
     // Next we will start the converter.
 #if POSTGRESQL_ENABLED
     ConvertPostgre(&settings);
 #else
     if ( settings.output_csv )
         ConvertFilesCSV(&settings);
-    else
-        ConvertFiles(&settings);
+    else {
+        try {
+            if ( settings.flat_output != FlatOutput::none )
+                ConvertFilesFlat(&settings);
+            else
+                ConvertFiles(&settings);
+        } catch ( const std::runtime_error &e ){
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
 
 #endif // POSTGRESQL_ENABLED
     return 0;
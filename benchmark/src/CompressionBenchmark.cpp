@@ -0,0 +1,112 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+/*!
+ * Benchmark of the output settings of the tree.
+ * The same synthetic run is written with a matrix of compression, basket
+ * size and auto flush settings. For each combination the write rate, the
+ * file size and the rate when reading all branches back are reported.
+ * The storage precisions of the hits are then compared with zstd.
+ *
+ * Usage: CompressionBenchmark [events per run] [output file]
+ */
+
+#include "SyntheticEvents.h"
+
+#include <Event/iThembaEvent.h>
+#include <RootInterface/RootFileManager.h>
+#include <RootInterface/TreeManager.h>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//! Time since start in seconds.
+inline double Since(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//! Write the run with the given options, return the time used in seconds.
+double Write(const std::vector<std::vector<Parser::Entry_t> > &pool, const size_t &num_events,
+             const RootOutputOptions &options, const char *fname)
+{
+    auto start = std::chrono::steady_clock::now();
+    {
+        RootFileManager fileManager(fname, "RECREATE", "CompressionBenchmark", options);
+        TreeManager treeManager(&fileManager, "events", "Events", new Event::iThembaEvent);
+        Event::iThembaEvent evt;
+        for ( size_t n = 0 ; n < num_events ; ++n ){
+            const std::vector<Parser::Entry_t> &entries = pool[n % pool.size()];
+            evt.Fill(entries.data(), entries.data() + entries.size());
+            treeManager.AddEntry(&evt);
+        }
+    }
+    return Since(start);
+}
+
+//! Read all branches of the run, return the time used in seconds.
+double Read(const char *fname, long long &size)
+{
+    auto start = std::chrono::steady_clock::now();
+    TFile file(fname, "READ");
+    size = file.GetSize();
+    auto *tree = dynamic_cast<TTree *>(file.Get("events"));
+    if ( !tree )
+        throw std::runtime_error("No tree in '" + std::string(fname) + "'");
+    const long long entries = tree->GetEntries();
+    for ( long long n = 0 ; n < entries ; ++n )
+        tree->GetEntry(n);
+    return Since(start);
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t num_events = ( argc > 1 ) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    const char *fname = ( argc > 2 ) ? argv[2] : "CompressionBenchmark.root";
+
+    const std::vector<std::string> compressions = {"none", "zlib", "lz4", "zstd", "lzma"};
+    const std::vector<int> basket_sizes = {32000, 256000, 1024000};
+    const std::vector<long long> autoflushes = {-30000000, -100000000};
+
+    auto pool = MakeEvents(100000);
+
+    std::cout << "Events per run: " << num_events << std::endl;
+    std::cout << "Compression\tBasket [B]\tAutoFlush [B]\tWrite [ev/s]\tSize [MB]\tRead [ev/s]" << std::endl;
+    for ( auto &compression : compressions ){
+        for ( auto &basket_size : basket_sizes ){
+            for ( auto &autoflush : autoflushes ){
+                RootOutputOptions options = {ParseCompression(compression), basket_size, autoflush, 0, Event::FullPrecision()};
+                const double write_time = Write(pool, num_events, options, fname);
+                long long size = 0;
+                const double read_time = Read(fname, size);
+                std::printf("%s\t\t%d\t\t%lld\t%.3g\t\t%.1f\t\t%.3g\n", compression.c_str(), basket_size, -autoflush,
+                            num_events/write_time, size/1e6, num_events/read_time);
+            }
+        }
+    }
+
+    const std::vector<std::pair<std::string, Event::StorageOptions> > storages = {
+        {"full", Event::FullPrecision()},
+        {"float", {32, 0, 0, false}},
+        {"reduced", {12, 16, 128, true}}
+    };
+    std::cout << "Storage\t\tWrite [ev/s]\tSize [MB]\tRead [ev/s]" << std::endl;
+    for ( auto &storage : storages ){
+        RootOutputOptions options = {ParseCompression("zstd"), 256000, -30000000, 0, storage.second};
+        const double write_time = Write(pool, num_events, options, fname);
+        long long size = 0;
+        const double read_time = Read(fname, size);
+        std::printf("%s\t\t%.3g\t\t%.1f\t\t%.3g\n", storage.first.c_str(),
+                    num_events/write_time, size/1e6, num_events/read_time);
+    }
+    std::remove(fname);
+    return 0;
+}
@@ -0,0 +1,54 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef SYNTHETICEVENTS_H
+#define SYNTHETICEVENTS_H
+
+#include <Parameters/experimentsetup.h>
+#include <Parser/Entry.h>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+//! Make a pool of synthetic events with a realistic mix of detector types.
+inline std::vector<std::vector<Parser::Entry_t> > MakeEvents(const size_t &num)
+{
+    std::vector<uint16_t> addresses;
+    for ( uint16_t address = 0 ; address < TOTAL_NUMBER_OF_ADDRESSES ; ++address ){
+        switch ( GetDetectorType(address) ){
+            case labr_3x8 : case labr_2x2_ss : case labr_2x2_fs : case clover : case de_ring : case de_sect : case eDet :
+                addresses.push_back(address);
+                break;
+            default :
+                break;
+        }
+    }
+    if ( addresses.empty() )
+        throw std::runtime_error("No detectors in the experiment setup");
+
+    std::mt19937 gen(42);
+    std::poisson_distribution<int> mult(4);
+    std::uniform_int_distribution<size_t> pick(0, addresses.size() - 1);
+    std::uniform_int_distribution<int> adc(0, 16383);
+    std::uniform_int_distribution<int> time(0, 1500);
+
+    std::vector<std::vector<Parser::Entry_t> > events(num);
+    int64_t timestamp = 0;
+    for ( auto &event : events ){
+        const int n = 1 + mult(gen);
+        for ( int i = 0 ; i < n ; ++i ){
+            Parser::Entry_t entry = {};
+            entry.address = addresses[pick(gen)];
+            entry.adcdata = uint16_t(adc(gen));
+            entry.energy = entry.adcdata;
+            entry.timestamp = timestamp + time(gen);
+            event.push_back(entry);
+        }
+        timestamp += 10000;
+    }
+    return events;
+}
+
+#endif // SYNTHETICEVENTS_H
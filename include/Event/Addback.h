@@ -0,0 +1,34 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef ADDBACK_H
+#define ADDBACK_H
+
+#include "Event/EntryColumns.h"
+
+class TH2;
+
+//! Max. number of hits in a single clover detector that are merged by the addback. Any further hits are kept as they are.
+#define MAX_ADDBACK_HITS 16
+
+namespace Event {
+
+    /*!
+     * Clover addback.
+     * \brief Merges the hits of the crystals in each clover detector within the addback time gate.
+     * \details The hits of each clover are sorted into fixed size scratch lists. In each
+     * clover the hit with the highest energy is used as seed, and the energy of all
+     * hits within the time gate of the seed are added to it. This is repeated with
+     * the remaining hits until all hits of the clover are used. The merged hits get
+     * the ID, time and CFD flag of the seed and a raw energy of 0. No allocations
+     * are done once the scratch storage is large enough for the event.
+     * \param clover Clover hits, replaced by the merged hits.
+     * \param scratch Storage for a copy of the hits.
+     * \param ab_t_clover Time difference between the first seed and the other hits of the clover.
+     */
+    void Addback(EntryColumns &clover, EntryColumns &scratch, TH2 *ab_t_clover);
+
+}
+
+#endif // ADDBACK_H
@@ -0,0 +1,103 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef ENTRYCOLUMNS_H
+#define ENTRYCOLUMNS_H
+
+#include <vector>
+#include <cstdint>
+
+class TBranch;
+
+namespace Event {
+
+    /*!
+     * Column storage for the entries of one detector type in an event.
+     * \brief Variable multiplicity storage without an upper limit.
+     * \details The columns are stored in a small inline buffer as long as the
+     * multiplicity is at most inline_capacity. Beyond that all columns are moved
+     * into a single heap allocated arena, with each column at a fixed offset.
+     * The arena is kept when the object is reset, such that reusing the object
+     * for a new event does not allocate. Branches registered with SetBranch
+     * are pointed to the new storage whenever the columns move.
+     */
+    class EntryColumns {
+
+    public:
+
+        //! The columns.
+        enum Column {
+            col_ID,
+            col_e_raw,
+            col_energy,
+            col_tfine,
+            col_tcoarse,
+            col_cfdvalid,
+            num_columns
+        };
+
+        //! Number of entries that fits without any heap allocation.
+        static const int inline_capacity = 8;
+
+        int mult;           //!< Number of entries stored.
+        uint16_t *ID;       //!< ID's of the entries.
+        uint16_t *e_raw;    //!< Raw energy of the entries.
+        double *energy;     //!< Energy of the entries.
+        double *tfine;      //!< CFD correction of the timestamp.
+        int64_t *tcoarse;   //!< Timestamp of the entry.
+        bool *cfdvalid;     //!< Flag indicating if the CFD is valid.
+
+        //! Constructor.
+        EntryColumns();
+
+        //! Copy constructor. Branches are not copied.
+        EntryColumns(const EntryColumns &other);
+
+        //! Copy the entries of another object. Branches are kept.
+        EntryColumns &operator=(const EntryColumns &other);
+
+        //! Get the index of a new entry at the end, growing the storage if needed.
+        inline int Next()
+        {
+            if ( mult == capacity )
+                Grow(mult + 1);
+            return mult++;
+        }
+
+        //! Set branch to point to a column whenever the storage moves.
+        void SetBranch(const Column &column, TBranch *branch);
+
+        //! Get number of entries that can be stored before the storage has to grow.
+        inline int GetCapacity() const { return capacity; }
+
+    private:
+
+        //! Inline storage for low multiplicity events.
+        struct Inline_t {
+            double energy[inline_capacity];
+            double tfine[inline_capacity];
+            int64_t tcoarse[inline_capacity];
+            uint16_t ID[inline_capacity];
+            uint16_t e_raw[inline_capacity];
+            bool cfdvalid[inline_capacity];
+        } local;
+
+        int capacity;                           //!< Number of entries the columns can hold.
+        std::vector<int64_t> arena;             //!< Heap storage of all columns when spilled.
+        TBranch *branches[num_columns];         //!< Branches reading from the columns.
+
+        //! Point the columns into the inline storage.
+        void UseInline();
+
+        //! Move the columns to an arena with room for at least min_capacity entries.
+        void Grow(const int &min_capacity);
+
+        //! Point the branches to the columns.
+        void Rebind();
+
+    };
+
+}
+
+#endif // ENTRYCOLUMNS_H
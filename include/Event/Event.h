@@ -1,9 +1,11 @@
 #ifndef EVENT_BASE_H
 #define EVENT_BASE_H
 
-#include <map>
-#include <string>
+#include "Parameters/experimentsetup.h"
+#include "Event/StorageOptions.h"
 
+#include <cstdint>
+#include <limits>
 
 class TTree;
 
@@ -20,7 +22,13 @@ namespace Event {
         virtual ~EventData() = default;
 
         //! Set the branches of the tree to the event data.
-        virtual void SetupBranch(TTree *tree, const char *baseName) = 0;
+        virtual void SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage) = 0;
+
+        //! Get the timestamp of the first entry, the largest possible value if there are no entries.
+        virtual int64_t GetFirstTime() const = 0;
+
+        //! Set the columns stored differently from memory, called before each fill of the tree.
+        virtual void Encode(const int64_t &reference) = 0;
 
         //! Reset all data.
         virtual void Reset() = 0;
@@ -42,34 +50,36 @@ namespace Event {
 
     class Base {
 
-    protected:
-
-        //! Mapping of all the entries. In derived types every EventData member has to be registered here.
-        std::map<std::string, EventData *> event_data;
-
-        //! Register a member.
-        void Register(EventData *member, const std::string &name) {
-            event_data[name] = member;
-        }
-
     public:
 
         //! Destructor
         virtual ~Base() = default;
 
-        //! Copy contents of another event.
-        void Copy(Base *other_event) {
-            for (auto &data : event_data) {
-                data.second->Copy(other_event->event_data[data.first]);
-            }
-        }
+        //! Copy contents of another event of the same type.
+        virtual void Copy(const Base *other_event) = 0;
+
+        //! Reset all the event data, such that the object can be reused for a new event.
+        virtual void Reset() = 0;
 
         //! Set the branches of the tree to the event data.
-        void SetupTree(TTree *tree) {
-            for (auto &entry_container : event_data) {
-                entry_container.second->SetupBranch(tree, entry_container.first.c_str());
-            }
-        }
+        virtual void SetupTree(TTree *tree) = 0;
+
+        /*!
+         * Set the branches of the components with a detector type in the mask.
+         * Components without branches are still filled, but not written.
+         * @param tree - tree where the event will be written.
+         * @param types - mask with bit n set for detector type n.
+         */
+        virtual void SetupTree(TTree *tree, const unsigned &types) = 0;
+
+        //! Set how the event is stored in the tree, has to be called before the tree is set up.
+        virtual void SetStorage(const StorageOptions &options) = 0;
+
+        //! Prepare the branches stored differently from memory, called before each fill of the tree.
+        virtual void Encode() = 0;
+
+        //! Get the timestamp of the first entry of the event, the largest possible value if empty.
+        virtual int64_t GetFirstTime() const = 0;
 
         /*!
          * New method
@@ -79,6 +89,119 @@ namespace Event {
 
     };
 
+    /*!
+     * Implements the Base interface from a compile time list of components.
+     * \tparam Derived event type. It has to implement a static method
+     * \code
+     * template<class F> static void ForEach(F &&f);
+     * \endcode
+     * calling f(&Derived::member, "name", type) for every EventData member,
+     * where type is the detector type the member holds, or any for members
+     * derived from several detector types.
+     * All loops over the components are then unrolled at compile time.
+     */
+    template<class Derived>
+    class EventType : public Base {
+
+    private:
+
+        StorageOptions storage;     //!< How the event is stored in the tree.
+        int64_t event_time;         //!< Start of the event, reference of the stored time differences.
+
+        struct CopyComponent {
+            Derived *to;
+            const Derived *from;
+            template<class T> inline void operator()(T Derived::*member, const char *, DetectorType) const
+            { (to->*member).Copy(&(from->*member)); }
+        };
+
+        struct ResetComponent {
+            Derived *event;
+            template<class T> inline void operator()(T Derived::*member, const char *, DetectorType) const
+            { (event->*member).Reset(); }
+        };
+
+        struct SetupComponent {
+            Derived *event;
+            TTree *tree;
+            unsigned types;
+            const StorageOptions &storage;
+            template<class T> inline void operator()(T Derived::*member, const char *name, DetectorType type) const
+            {
+                if ( types & (1u << type) )
+                    (event->*member).SetupBranch(tree, name, storage);
+            }
+        };
+
+        struct FirstTimeComponent {
+            const Derived *event;
+            int64_t &first;
+            template<class T> inline void operator()(T Derived::*member, const char *, DetectorType) const
+            {
+                const int64_t t = (event->*member).GetFirstTime();
+                if ( t < first )
+                    first = t;
+            }
+        };
+
+        struct EncodeComponent {
+            Derived *event;
+            int64_t reference;
+            template<class T> inline void operator()(T Derived::*member, const char *, DetectorType) const
+            { (event->*member).Encode(reference); }
+        };
+
+    public:
+
+        //! Constructor.
+        EventType() : storage( FullPrecision() ), event_time( 0 ){}
+
+        //! Copy contents of another event of the same type.
+        void Copy(const Base *other_event) override {
+            if ( other_event == nullptr )
+                return;
+            Derived::ForEach(CopyComponent{static_cast<Derived *>(this), static_cast<const Derived *>(other_event)});
+        }
+
+        //! Reset all the event data.
+        void Reset() override {
+            Derived::ForEach(ResetComponent{static_cast<Derived *>(this)});
+        }
+
+        //! Set the branches of the tree to the event data.
+        void SetupTree(TTree *tree) override {
+            SetupTree(tree, ALL_DETECTOR_TYPES);
+        }
+
+        //! Set the branches of the components with a detector type in the mask.
+        void SetupTree(TTree *tree, const unsigned &types) override {
+            Derived::ForEach(SetupComponent{static_cast<Derived *>(this), tree, types, storage});
+            if ( storage.tcoarse_delta )
+                SetupEventTime(tree, &event_time);
+        }
+
+        //! Set how the event is stored in the tree.
+        void SetStorage(const StorageOptions &options) override { storage = options; }
+
+        //! Get the timestamp of the first entry of the event.
+        int64_t GetFirstTime() const override {
+            int64_t first = std::numeric_limits<int64_t>::max();
+            Derived::ForEach(FirstTimeComponent{static_cast<const Derived *>(this), first});
+            return first;
+        }
+
+        //! Set the start of the event and the time differences, if stored.
+        void Encode() override {
+            if ( !storage.tcoarse_delta )
+                return;
+            event_time = GetFirstTime();
+            if ( event_time == std::numeric_limits<int64_t>::max() )
+                event_time = 0;
+            Derived::ForEach(EncodeComponent{static_cast<Derived *>(this), event_time});
+        }
+
+    };
+
 }
 
 #endif // EVENT_BASE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef EVENTBUILDER_H
+#define EVENTBUILDER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <Parser/Entry.h>
+#include <Parameters/experimentsetup.h>
+
+#include "Event/TriggerCondition.h"
+
+namespace Event {
+
+    //! How entries are grouped into events when there is no trigger.
+    enum WindowMode {
+        fixed_window,   //!< Windows of fixed length, starting at the first entry not in the previous window.
+        gap_window      //!< Windows closed when the time to the next entry exceeds the window length.
+    };
+
+    //! An event, given as a range of indices into a time ordered list of entries.
+    struct EventRange {
+        uint32_t begin;     //!< Index of the first entry in the event.
+        uint32_t end;       //!< Index one past the last entry in the event.
+    };
+
+    //! A time ordered chunk of entries together with the events built from it.
+    /*!
+     * The events refers to the entries of the chunk, such that building
+     * an event does not require any copy or allocation.
+     */
+    struct EventChunk {
+        uint64_t sequence = 0;                  //!< Position of the chunk in the input stream.
+        std::vector<Parser::Entry_t> entries;   //!< Time ordered entries.
+        std::vector<EventRange> events;         //!< Events built from the entries.
+    };
+
+    /*!
+     * Sliding window event builder.
+     * \brief Builds events around trigger entries in a time ordered list of entries.
+     * \details Two indices are moved over the entries, the start of the window
+     * and the end of the window. As the triggers are time ordered neither of them
+     * ever moves backwards, such that each entry is visited at most twice.
+     * An entry is never part of more than one event. If a trigger condition
+     * is given, windows not fulfilling it are dropped, but their entries are
+     * still not part of any other event.
+     */
+    class EventBuilder {
+
+    private:
+
+        DetectorType trigger;                   //!< Detector type of the trigger.
+        double window;                          //!< Maximum time difference between an entry and the trigger.
+        const TriggerCondition *condition;      //!< Condition the events has to fulfill, may be null.
+
+    public:
+
+        //! Constructor.
+        EventBuilder(const DetectorType &trigger_type,                  /*!< Detector type of the trigger.      */
+                     const double &event_time,                          /*!< Event window [ns].                 */
+                     const TriggerCondition *trigger_condition=nullptr  /*!< Condition events has to fulfill.   */)
+            : trigger( trigger_type ), window( event_time ), condition( trigger_condition ){}
+
+        /*!
+         * Build events from a list of time ordered entries.
+         * \param entries Time ordered entries.
+         * \param size Number of entries.
+         * \param events Vector where the events found will be appended.
+         * \param flush If false, events that may extend past the last entry are not built.
+         * \return Index of the first entry that may still be part of an event not yet built.
+         *   Equal to size if flushing.
+         */
+        size_t BuildEvents(const Parser::Entry_t *entries, const size_t &size,
+                           std::vector<EventRange> &events, const bool &flush=true) const;
+
+        /*!
+         * Build events from a list of time ordered entries without any trigger.
+         * \details The entries are cut into consecutive windows in a single pass,
+         * every entry ends up in exactly one window. Windows not fulfilling the
+         * trigger condition, if any, are dropped.
+         * \param entries Time ordered entries.
+         * \param size Number of entries.
+         * \param events Vector where the events found will be appended.
+         * \param mode Fixed length or gap based windows. The event window sets the length/gap.
+         */
+        void BuildWindows(const Parser::Entry_t *entries, const size_t &size,
+                          std::vector<EventRange> &events, const WindowMode &mode) const;
+
+    };
+
+}
+
+#endif // EVENTBUILDER_H
@@ -0,0 +1,99 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef STORAGEOPTIONS_H
+#define STORAGEOPTIONS_H
+
+#include <vector>
+#include <cstdint>
+
+class TTree;
+class TBranch;
+
+namespace Event {
+
+    /*!
+     * How the hits are stored in the tree. The events in memory always keep full precision,
+     * only the branches are changed. Zero bits stores the full precision.
+     */
+    struct StorageOptions {
+        int energy_bits;        //!< 0: double, 32: float (Double32_t), 2-14: mantissa bits kept (Float16_t style).
+        int tfine_bits;         //!< 0: double, 2-32: fixed point fraction of [-tfine_range, tfine_range).
+        double tfine_range;     //!< Range of the fixed point fine time [ns], values outside are clamped.
+        bool tcoarse_delta;     //!< Store the timestamps as 32 bit differences to the start of the event.
+    };
+
+    //! Get storage options keeping the full precision.
+    inline StorageOptions FullPrecision(){ return {0, 0, 128, false}; }
+
+    /*!
+     * Check that the storage options are valid.
+     * \throws std::invalid_argument if any of the options are out of range.
+     */
+    void CheckStorage(const StorageOptions &options);
+
+    /*!
+     * Get the leaf type of a double column of energies.
+     * @param type - buffer the type is written to, e.g. "D" or "d[0,0,12]".
+     * @param options - storage options.
+     */
+    void EnergyLeafType(char *type, const StorageOptions &options);
+
+    /*!
+     * Get the leaf type of a double column of fine times.
+     * @param type - buffer the type is written to, e.g. "D" or "d[-128,128,16]".
+     * @param options - storage options.
+     */
+    void TfineLeafType(char *type, const StorageOptions &options);
+
+    /*!
+     * Create the branch with the start time of the event, used as reference of the time differences.
+     * @param tree - tree to create the branch in.
+     * @param event_time - start time of the event.
+     */
+    void SetupEventTime(TTree *tree, int64_t *event_time);
+
+    /*!
+     * Column with the timestamps of the entries relative to the start of the event.
+     * \brief Delta encoded coarse time.
+     */
+    class DeltaColumn {
+
+    private:
+
+        std::vector<int32_t> delta;     //!< Time differences of the current event.
+        TBranch *branch;                //!< Branch reading from the column.
+
+    public:
+
+        //! Constructor.
+        DeltaColumn() : delta( 8 ), branch( nullptr ){}
+
+        //! Copy constructor. The copy is not attached to any tree.
+        DeltaColumn(const DeltaColumn &other) : delta( other.delta.size() ), branch( nullptr ){}
+
+        //! Nothing to copy, the differences are set by Encode.
+        DeltaColumn &operator=(const DeltaColumn &){ return *this; }
+
+        /*!
+         * Create the branch.
+         * @param tree - tree to create the branch in.
+         * @param name - name of the branch.
+         * @param mult_name - name of the multiplicity branch.
+         */
+        void SetupBranch(TTree *tree, const char *name, const char *mult_name);
+
+        /*!
+         * Set the differences of the timestamps to the reference.
+         * @param tcoarse - timestamps.
+         * @param mult - number of timestamps.
+         * @param reference - time the differences are relative to.
+         */
+        void Encode(const int64_t *tcoarse, const int &mult, const int64_t &reference);
+
+    };
+
+}
+
+#endif // STORAGEOPTIONS_H
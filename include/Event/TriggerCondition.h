@@ -0,0 +1,81 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef TRIGGERCONDITION_H
+#define TRIGGERCONDITION_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <Parser/Entry.h>
+#include <Parameters/experimentsetup.h>
+
+namespace Event {
+
+    /*!
+     * Coincidence condition an event has to fulfill to be kept.
+     * \brief Compiled from an expression like "de_ring & (labr_3x8 | clover>=2)".
+     * \details The expression consists of detector type names combined with
+     * '&' (and), '|' (or) and parentheses. A detector type may be followed by
+     * ">=N" or ">N" to require a minimum number of entries of that type.
+     * The expression is compiled to a list of terms (disjunctive normal form),
+     * each term being a mask of the detector types required and the minimum
+     * multiplicity of each type. A set of entries is tested by building the
+     * mask of types present once, and comparing it to each term.
+     *
+     * As there is no negation, a condition that fails for a set of entries
+     * fails for any subset as well. Thus a whole chunk of entries can be
+     * rejected before building any events from it.
+     */
+    class TriggerCondition {
+
+    public:
+
+        //! Number of detector types.
+        static const int num_types = DetectorType::unused + 1;
+
+    private:
+
+        //! A single term of the condition, all requirements has to be fulfilled.
+        struct Term {
+            uint32_t mask;              //!< Detector types required.
+            uint32_t mult_mask;         //!< Detector types with a multiplicity above one required.
+            int mult[num_types];        //!< Minimum number of entries of each type.
+        };
+
+        //! The condition is fulfilled if any of the terms are.
+        std::vector<Term> terms;
+
+        //! Expression the condition was compiled from.
+        std::string expression;
+
+    public:
+
+        /*!
+         * Compile a condition.
+         * \param expr Expression to compile.
+         * \throws std::invalid_argument if the expression is malformed.
+         */
+        explicit TriggerCondition(const std::string &expr);
+
+        //! Test if a set of entries fulfills the condition.
+        bool Accept(const Parser::Entry_t *begin, const Parser::Entry_t *end) const;
+
+        //! Get the expression the condition was compiled from.
+        inline const std::string &GetExpression() const { return expression; }
+
+        //! Get the number of terms after compilation.
+        inline size_t GetNumTerms() const { return terms.size(); }
+
+    private:
+
+        //! Helper class doing the actual parsing.
+        friend class ConditionParser;
+
+    };
+
+}
+
+#endif // TRIGGERCONDITION_H
@@ -5,11 +5,13 @@
 #ifndef ITLEVENT_H
 #define ITLEVENT_H
 
+#include <vector>
+
 #include "Parser/Entry.h"
 #include "Event/Event.h"
+#include "Event/EntryColumns.h"
 
-#define MAX_MULT 256
-
+class TH2;
 class TBranch;
 
 namespace Event {
@@ -25,16 +27,13 @@ namespace Event {
     };
 
     //! Data type to store iTL data
-    class iTLData : public EventData {
+    class iTLData final : public EventData {
+
+        friend class iTLEvent;
 
     private:
-        int         mult;               //!< Event multiplicity
-        uint16_t    ID[MAX_MULT];       //!< Entry detector ID
-        uint16_t    e_raw[MAX_MULT];    //!< Raw channel # for energy
-        double      energy[MAX_MULT];   //!< Calibrated energy
-        double      tfine[MAX_MULT];    //!< CFD correction
-        int64_t     tcoarse[MAX_MULT];  //!< Timestamp of the entry
-        bool        cfdvalid[MAX_MULT]; //!< CFD flag
+        EntryColumns data;              //!< Entries, no upper limit on the multiplicity
+        DeltaColumn tdelta;             //!< Timestamps relative to the event, if stored so.
 
         // We also need to keep track of the branch
         TBranch *bMult;
@@ -50,10 +49,22 @@ namespace Event {
         /*!
          * Constructor
          */
-        iTLData() : mult(0), ID{}, e_raw{}, energy{}, tfine{}, tcoarse{}, cfdvalid{}
+        iTLData() : data()
                 , bMult( nullptr ), bID( nullptr ), bRaw( nullptr ), bEnergy( nullptr )
                 , bTfine( nullptr ), bTcoarse( nullptr ), bCfdvalid( nullptr ){}
 
+        /*!
+         * Copy constructor. The copy is not attached to any tree.
+         */
+        iTLData(const iTLData &other) : EventData(), data( other.data ), tdelta( other.tdelta )
+                , bMult( nullptr ), bID( nullptr ), bRaw( nullptr ), bEnergy( nullptr )
+                , bTfine( nullptr ), bTcoarse( nullptr ), bCfdvalid( nullptr ){}
+
+        /*!
+         * Copy the entries of another object.
+         */
+        iTLData &operator=(const iTLData &other){ data = other.data; return *this; }
+
         /*!
          * Destructor
          */
@@ -62,7 +73,7 @@ namespace Event {
         /*!
          * Add a word to this entry.
          * @param word - raw data from file.
-         * @return True if mult < MAX_NUM, false otherwise.
+         * @return Always true, the storage grows as needed.
          */
         bool Add(const Parser::Entry_t &word);
 
@@ -71,14 +82,26 @@ namespace Event {
         /*!
          * Reset the entries
          */
-        inline void Reset() override { mult = 0; }
+        inline void Reset() override { data.mult = 0; }
 
         /*!
          * Setup the correct branches.
          * @param tree - tree where this will be referred in.
          * @param baseName - base name of the branches.
+         * @param storage - how the entries are stored.
          */
-        void SetupBranch(TTree *tree, const char *baseName) override;
+        void SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage) override;
+
+        /*!
+         * Get the timestamp of the first entry.
+         */
+        inline int64_t GetFirstTime() const override
+        { return ( data.mult > 0 ) ? data.tcoarse[0] : std::numeric_limits<int64_t>::max(); }
+
+        /*!
+         * Set the timestamps relative to the event.
+         */
+        inline void Encode(const int64_t &reference) override { tdelta.Encode(data.tcoarse, data.mult, reference); }
 
         /*!
          * Copy data from a different object
@@ -92,7 +115,7 @@ namespace Event {
     };
 
 
-    class iTLEvent : public Base {
+    class iTLEvent : public EventType<iTLEvent> {
 
     protected:
 
@@ -105,8 +128,24 @@ namespace Event {
         iTLData cloverData;
         iTLData rfData;
 
+        EntryColumns addbackScratch;    //!< Scratch storage for the addback, not a part of the event.
+
     public:
 
+        //! Call f for every component of the event.
+        template<class F>
+        static inline void ForEach(F &&f)
+        {
+            f(&iTLEvent::ringData, "ring", de_ring);
+            f(&iTLEvent::sectData, "sector", de_sect);
+            f(&iTLEvent::backData, "back", eDet);
+            f(&iTLEvent::labrLData, "labrL", labr_3x8);
+            f(&iTLEvent::labrSData, "labrS", labr_2x2_ss);
+            f(&iTLEvent::labrFData, "labrF", labr_2x2_fs);
+            f(&iTLEvent::cloverData, "clover", clover);
+            f(&iTLEvent::rfData, "rf", rfchan);
+        }
+
         //! Constructor
         explicit iTLEvent(TTree *tree = nullptr);
 
@@ -161,6 +200,9 @@ namespace Event {
          */
         inline std::vector <iTLEntry> GetRF() const { return rfData.GetEntries(); }
 
+        /*!
+         * Run addback routine, replacing the clover hits by the merged hits.
+         */
         void Addback(TH2 *);
 
     };
@@ -9,14 +9,14 @@
 #include <cassert>
 
 #include "Event/Event.h"
+#include "Event/EntryColumns.h"
 #include "Parser/Entry.h"
+#include "Parameters/experimentsetup.h"
 
 class TH2;
 class TTree;
 class TBranch;
 
-#define MAX_NUM 128
-
 namespace Event {
 
     struct iThembaEntry {
@@ -28,18 +28,15 @@ namespace Event {
         bool cfdvalid;
     };
 
-    class iThembaData : public EventData
+    class iThembaData final : public EventData
     {
 
+        friend class iThembaEvent;
+
     private:
 
-        int mult;                   //!< Number of fields populated.
-        uint16_t ID[MAX_NUM];       //!< ID's of the entries.
-        uint16_t e_raw[MAX_NUM];    //!< Raw energy of the entries.
-        double energy[MAX_NUM];     //!< Energy of the entries.
-        double tfine[MAX_NUM];      //!< CFD correction of the timestamp.
-        int64_t tcoarse[MAX_NUM];   //!< Timestamp of the entry.
-        bool cfdvalid[MAX_NUM];     //!< Flag indicating if the CFD is valid.
+        EntryColumns data;          //!< Entries, no upper limit on the multiplicity.
+        DeltaColumn tdelta;         //!< Timestamps relative to the event, if stored so.
 
         TBranch *b_mult;
         TBranch *b_ID;
@@ -55,10 +52,23 @@ namespace Event {
          * Constructor.
          */
         iThembaData()
-        : mult(0), ID{}, e_raw{}, energy{}, tfine{}, tcoarse{}, cfdvalid{}
+        : data()
+        , b_mult( nullptr ), b_ID( nullptr ), b_e_raw( nullptr ), b_energy( nullptr )
+        , b_tfine( nullptr ), b_tcoarse( nullptr ), b_cfdvalid( nullptr ) {}
+
+        /*!
+         * Copy constructor. The copy is not attached to any tree.
+         */
+        iThembaData(const iThembaData &other)
+        : EventData(), data( other.data ), tdelta( other.tdelta )
         , b_mult( nullptr ), b_ID( nullptr ), b_e_raw( nullptr ), b_energy( nullptr )
         , b_tfine( nullptr ), b_tcoarse( nullptr ), b_cfdvalid( nullptr ) {}
 
+        /*!
+         * Copy the entries of another object.
+         */
+        iThembaData &operator=(const iThembaData &other){ data = other.data; return *this; }
+
         /*!
          * Destructor
          */
@@ -67,28 +77,40 @@ namespace Event {
         /*!
          * Add a word to this entry.
          * @param word - raw data from file.
-         * @return True if mult < MAX_NUM, false otherwise.
+         * @return Always true, the storage grows as needed.
          */
         bool Add(const Parser::Entry_t &word);
 
         /*!
          * Add a word to this entry.
          * @param word - raw data from file.
-         * @return True if mult < MAX_NUM, false otherwise.
+         * @return Always true, the storage grows as needed.
          */
         bool Add(const iThembaEntry &entry);
 
         /*!
          * Reset the class
          */
-        inline void Reset() override { mult = 0; }
+        inline void Reset() override { data.mult = 0; }
 
         /*!
          * Setup the correct branches.
          * @param tree - tree where this will be referred in.
          * @param baseName - base name of the branches.
+         * @param storage - how the entries are stored.
+         */
+        void SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage) override;
+
+        /*!
+         * Get the timestamp of the first entry.
+         */
+        inline int64_t GetFirstTime() const override
+        { return ( data.mult > 0 ) ? data.tcoarse[0] : std::numeric_limits<int64_t>::max(); }
+
+        /*!
+         * Set the timestamps relative to the event.
          */
-        void SetupBranch(TTree *tree, const char *baseName) override;
+        inline void Encode(const int64_t &reference) override { tdelta.Encode(data.tcoarse, data.mult, reference); }
 
         //void SetBranchAddress(EventData *other) override;
 
@@ -97,37 +119,42 @@ namespace Event {
         /*!
          * Get number of entries.
          */
-        inline int GetSize() const { return mult; }
+        inline int GetSize() const { return data.mult; }
 
         /*!
          * Get as TDREntry
          */
         inline iThembaEntry operator[](const int &i)
         {
-            assert(i < mult);
-            return {ID[i], e_raw[i], energy[i],
-                    tfine[i], tcoarse[i], cfdvalid[i]};
+            assert(i < data.mult);
+            return {data.ID[i], data.e_raw[i], data.energy[i],
+                    data.tfine[i], data.tcoarse[i], data.cfdvalid[i]};
         }
 
+        /*!
+         * Get the entries as columns, without any copy.
+         */
+        inline const EntryColumns &GetColumns() const { return data; }
+
         /*!
          * Get all entries as a vector.
          */
         inline std::vector <iThembaEntry> GetEntries() const
         {
-            std::vector <iThembaEntry> entries(mult);
-            for (int i = 0; i < mult; ++i) {
-                entries.push_back({ID[i], e_raw[i], energy[i], tfine[i], tcoarse[i], cfdvalid[i]});
+            std::vector <iThembaEntry> entries;
+            entries.reserve(data.mult);
+            for (int i = 0; i < data.mult; ++i) {
+                entries.push_back({data.ID[i], data.e_raw[i], data.energy[i], data.tfine[i], data.tcoarse[i], data.cfdvalid[i]});
             }
             return entries;
         }
 
     };
 
-    class iThembaTimeData : public EventData {
-        int mult;                   //!< Number of fields populated.
-        double tfine[MAX_NUM];      //!< CFD correction of the timestamp.
-        int64_t tcoarse[MAX_NUM];   //!< Timestamp of the entry.
-        bool cfdvalid[MAX_NUM];     //!< Flag indicating if the CFD is valid.
+    class iThembaTimeData final : public EventData {
+
+        EntryColumns data;          //!< Entries, only the time columns are used.
+        DeltaColumn tdelta;         //!< Timestamps relative to the event, if stored so.
 
         TBranch *b_mult;
         TBranch *b_tfine;
@@ -141,9 +168,21 @@ namespace Event {
          * Constructor.
          */
         iThembaTimeData()
-        : mult(0), tfine{}, tcoarse{}, cfdvalid{}
+        : data()
+        , b_mult( nullptr ), b_tfine( nullptr ), b_tcoarse( nullptr ), b_cfdvalid( nullptr ){}
+
+        /*!
+         * Copy constructor. The copy is not attached to any tree.
+         */
+        iThembaTimeData(const iThembaTimeData &other)
+        : EventData(), data( other.data ), tdelta( other.tdelta )
         , b_mult( nullptr ), b_tfine( nullptr ), b_tcoarse( nullptr ), b_cfdvalid( nullptr ){}
 
+        /*!
+         * Copy the entries of another object.
+         */
+        iThembaTimeData &operator=(const iThembaTimeData &other){ data = other.data; return *this; }
+
         /*!
          * Destructor
          */
@@ -152,28 +191,40 @@ namespace Event {
         /*!
          * Add a word to this entry.
          * @param word - raw data from file.
-         * @return True if mult < MAX_NUM, false otherwise.
+         * @return Always true, the storage grows as needed.
          */
         bool Add(const Parser::Entry_t &word);
 
         /*!
          * Add a word to this entry.
          * @param word - raw data from file.
-         * @return True if mult < MAX_NUM, false otherwise.
+         * @return Always true, the storage grows as needed.
          */
         bool Add(const iThembaEntry &entry);
 
         /*!
          * Reset the class
          */
-        inline void Reset() override { mult = 0; }
+        inline void Reset() override { data.mult = 0; }
 
         /*!
          * Setup the correct branches.
          * @param tree - tree where this will be referred in.
          * @param baseName - base name of the branches.
+         * @param storage - how the entries are stored.
+         */
+        void SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage) override;
+
+        /*!
+         * Get the timestamp of the first entry.
+         */
+        inline int64_t GetFirstTime() const override
+        { return ( data.mult > 0 ) ? data.tcoarse[0] : std::numeric_limits<int64_t>::max(); }
+
+        /*!
+         * Set the timestamps relative to the event.
          */
-        void SetupBranch(TTree *tree, const char *baseName) override;
+        inline void Encode(const int64_t &reference) override { tdelta.Encode(data.tcoarse, data.mult, reference); }
 
         void Copy(const EventData *other) override;
 
@@ -182,25 +233,31 @@ namespace Event {
         /*!
          * Get number of entries.
          */
-        inline int GetSize() const { return mult; }
+        inline int GetSize() const { return data.mult; }
 
         /*!
          * Get as TDREntry
          */
         inline iThembaEntry operator[](const int &i)
         {
-            assert(i < mult);
-            return {0, 0, 0,tfine[i], tcoarse[i], cfdvalid[i]};
+            assert(i < data.mult);
+            return {0, 0, 0, data.tfine[i], data.tcoarse[i], data.cfdvalid[i]};
         }
 
+        /*!
+         * Get the entries as columns, without any copy.
+         */
+        inline const EntryColumns &GetColumns() const { return data; }
+
         /*!
          * Get all entries as a vector.
          */
         inline std::vector<iThembaEntry> GetEntries() const
         {
-            std::vector<iThembaEntry> entries(mult);
-            for ( int i = 0 ; i < mult ; ++i ){
-                entries.push_back({0, 0, 0, tfine[i], tcoarse[i], cfdvalid[i]});
+            std::vector<iThembaEntry> entries;
+            entries.reserve(data.mult);
+            for ( int i = 0 ; i < data.mult ; ++i ){
+                entries.push_back({0, 0, 0, data.tfine[i], data.tcoarse[i], data.cfdvalid[i]});
             }
             return entries;
         }
@@ -208,7 +265,135 @@ namespace Event {
     };
 
 
-    class iThembaEvent : public Base
+    //! A reconstructed particle hit in a dE-E telescope.
+    struct iThembaParticle {
+        int16_t telescope;  //!< Telescope number.
+        uint16_t ring;      //!< ID of the dE ring.
+        int16_t sect;       //!< ID of the dE sector, -1 if no sector was matched.
+        uint16_t back;      //!< ID of the E back detector.
+        double dE;          //!< Energy deposited in the dE ring.
+        double E;           //!< Energy deposited in the E back detector.
+        double theta;       //!< Scattering angle of the ring [deg].
+        double tfine;       //!< CFD correction of the E timestamp.
+        int64_t tcoarse;    //!< Timestamp of the E hit.
+    };
+
+    class iThembaParticleData final : public EventData {
+
+    private:
+
+        int mult;                       //!< Number of particles.
+        int capacity;                   //!< Number of particles the columns can hold.
+        std::vector<int16_t> telescope; //!< Telescope number.
+        std::vector<uint16_t> ring;     //!< ID of the dE ring.
+        std::vector<int16_t> sect;      //!< ID of the dE sector, -1 if none.
+        std::vector<uint16_t> back;     //!< ID of the E back detector.
+        std::vector<double> dE;         //!< Energy deposited in the dE ring.
+        std::vector<double> E;          //!< Energy deposited in the E back detector.
+        std::vector<double> theta;      //!< Scattering angle [deg].
+        std::vector<double> tfine;      //!< CFD correction of the E timestamp.
+        std::vector<int64_t> tcoarse;   //!< Timestamp of the E hit.
+        DeltaColumn tdelta;             //!< Timestamps relative to the event, if stored so.
+
+        TBranch *b_mult;
+        TBranch *b_telescope;
+        TBranch *b_ring;
+        TBranch *b_sect;
+        TBranch *b_back;
+        TBranch *b_dE;
+        TBranch *b_E;
+        TBranch *b_theta;
+        TBranch *b_tfine;
+        TBranch *b_tcoarse;
+
+        //! Grow the columns to hold at least min_capacity particles.
+        void Grow(const int &min_capacity);
+
+    public:
+
+        /*!
+         * Constructor.
+         */
+        iThembaParticleData();
+
+        /*!
+         * Copy constructor. The copy is not attached to any tree.
+         */
+        iThembaParticleData(const iThembaParticleData &other);
+
+        /*!
+         * Copy the particles of another object.
+         */
+        iThembaParticleData &operator=(const iThembaParticleData &other){ Copy(&other); return *this; }
+
+        /*!
+         * Destructor
+         */
+        ~iThembaParticleData() override = default;
+
+        /*!
+         * Add a particle.
+         */
+        void Add(const iThembaParticle &particle);
+
+        /*!
+         * Reset the class
+         */
+        inline void Reset() override { mult = 0; }
+
+        /*!
+         * Setup the correct branches.
+         * @param tree - tree where this will be referred in.
+         * @param baseName - base name of the branches.
+         * @param storage - how the particles are stored.
+         */
+        void SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage) override;
+
+        /*!
+         * Get the timestamp of the first particle.
+         */
+        inline int64_t GetFirstTime() const override
+        { return ( mult > 0 ) ? tcoarse[0] : std::numeric_limits<int64_t>::max(); }
+
+        /*!
+         * Set the timestamps relative to the event.
+         */
+        inline void Encode(const int64_t &reference) override { tdelta.Encode(tcoarse.data(), mult, reference); }
+
+        void Copy(const EventData *other) override;
+
+        /*!
+         * Get number of particles.
+         */
+        inline int GetSize() const { return mult; }
+
+        /*!
+         * Get a particle.
+         */
+        inline iThembaParticle operator[](const int &i) const
+        {
+            assert(i < mult);
+            return {telescope[i], ring[i], sect[i], back[i], dE[i], E[i], theta[i], tfine[i], tcoarse[i]};
+        }
+
+        /*!
+         * Get the dE energy of a particle.
+         */
+        inline double GetdE(const int &i) const { return dE[i]; }
+
+        /*!
+         * Get the E energy of a particle.
+         */
+        inline double GetE(const int &i) const { return E[i]; }
+
+        /*!
+         * Get all particles as a vector.
+         */
+        std::vector<iThembaParticle> GetEntries() const;
+
+    };
+
+    class iThembaEvent : public EventType<iThembaEvent>
     {
 
     protected:
@@ -221,9 +406,28 @@ namespace Event {
         iThembaData labrFData;     //!< LaBr 2x2" (fast signal) event structure.
         iThembaData cloverData;    //!< CLOVER event structure.
         iThembaTimeData rfData;    //!< RF event structure.
+        iThembaParticleData particleData;   //!< Reconstructed dE-E particles.
+
+        EntryColumns addbackScratch;    //!< Scratch storage for the addback, not a part of the event.
+        std::vector<char> dEused;       //!< Scratch flags for the particle reconstruction, not a part of the event.
 
     public:
 
+        //! Call f for every component of the event.
+        template<class F>
+        static inline void ForEach(F &&f)
+        {
+            f(&iThembaEvent::ringData, "ring", de_ring);
+            f(&iThembaEvent::sectData, "sector", de_sect);
+            f(&iThembaEvent::backData, "back", eDet);
+            f(&iThembaEvent::labrLData, "labrL", labr_3x8);
+            f(&iThembaEvent::labrSData, "labrS", labr_2x2_ss);
+            f(&iThembaEvent::labrFData, "labrF", labr_2x2_fs);
+            f(&iThembaEvent::cloverData, "clover", clover);
+            f(&iThembaEvent::rfData, "rf", rfchan);
+            f(&iThembaEvent::particleData, "particle", any);    // Reconstructed from several types
+        }
+
         //! Constructor.
         explicit iThembaEvent(TTree *tree = nullptr);
 
@@ -233,6 +437,21 @@ namespace Event {
          */
         explicit iThembaEvent(const std::vector <Parser::Entry_t> &data);
 
+        /*!
+         * Set the event from a range of raw data.
+         * @param begin - first entry of the event.
+         * @param end - one past the last entry of the event.
+         */
+        iThembaEvent(const Parser::Entry_t *begin, const Parser::Entry_t *end);
+
+        /*!
+         * Reset the event and fill it from a range of raw data.
+         * Allows a single object to be reused for all events.
+         * @param begin - first entry of the event.
+         * @param end - one past the last entry of the event.
+         */
+        void Fill(const Parser::Entry_t *begin, const Parser::Entry_t *end);
+
         /*!
          * Return a new object
          * @return a new object of same type.
@@ -240,7 +459,8 @@ namespace Event {
         inline Base *New() override { return new iThembaEvent; }
 
         /*!
-         * Run addback routine.
+         * Run addback routine, replacing the clover hits by the merged hits.
+         * @param hist - filled with the time difference between the hits of each clover, may be null.
          */
         void Addback(TH2 *hist);
 
@@ -249,41 +469,106 @@ namespace Event {
          */
         inline std::vector <iThembaEntry> GetRing() const { return ringData.GetEntries(); }
 
+        /*!
+         * Get ring data as columns, without any copy.
+         */
+        inline const EntryColumns &GetRingColumns() const { return ringData.GetColumns(); }
+
         /*!
          * Get sector data.
          */
         inline std::vector <iThembaEntry> GetSect() const { return sectData.GetEntries(); }
 
+        /*!
+         * Get sector data as columns, without any copy.
+         */
+        inline const EntryColumns &GetSectColumns() const { return sectData.GetColumns(); }
+
         /*!
          * Get back data.
          */
         inline std::vector <iThembaEntry> GetBack() const { return backData.GetEntries(); }
 
+        /*!
+         * Get back data as columns, without any copy.
+         */
+        inline const EntryColumns &GetBackColumns() const { return backData.GetColumns(); }
+
         /*!
          * Get LaBr L data.
          */
         inline std::vector <iThembaEntry> GetLabrL() const { return labrLData.GetEntries(); }
 
+        /*!
+         * Get LaBr L data as columns, without any copy.
+         */
+        inline const EntryColumns &GetLabrLColumns() const { return labrLData.GetColumns(); }
+
         /*!
          * Get LaBr S data.
          */
         inline std::vector <iThembaEntry> GetLabrS() const { return labrSData.GetEntries(); }
 
+        /*!
+         * Get LaBr S data as columns, without any copy.
+         */
+        inline const EntryColumns &GetLabrSColumns() const { return labrSData.GetColumns(); }
+
         /*!
          * Get LaBr F data.
          */
         inline std::vector <iThembaEntry> GetLabrF() const { return labrFData.GetEntries(); }
 
+        /*!
+         * Get LaBr F data as columns, without any copy.
+         */
+        inline const EntryColumns &GetLabrFColumns() const { return labrFData.GetColumns(); }
+
         /*!
          * Get CLOVER data.
          */
         inline std::vector <iThembaEntry> GetClover() const { return cloverData.GetEntries(); }
 
+        /*!
+         * Get CLOVER data as columns, without any copy.
+         */
+        inline const EntryColumns &GetCloverColumns() const { return cloverData.GetColumns(); }
+
         /*!
          * Get CLOVER data.
          */
         inline std::vector <iThembaEntry> GetRF() const { return rfData.GetEntries(); }
 
+        /*!
+         * Get RF data as columns, without any copy.
+         */
+        inline const EntryColumns &GetRFColumns() const { return rfData.GetColumns(); }
+
+        /*!
+         * Get the data of a detector type as columns, without any copy.
+         * @param type - detector type.
+         * @return the columns, null if the event has no data of the type.
+         */
+        const EntryColumns *GetColumns(const DetectorType &type) const;
+
+        /*!
+         * Reconstruct particle hits from the ring, sector and back data.
+         * Each back hit is matched with the ring and sector hit of the same telescope
+         * with the highest energy within the particle time gate. A ring hit is
+         * required, the sector is optional. Each dE hit is used at most once.
+         */
+        void ReconstructParticles();
+
+        /*!
+         * Get reconstructed particles.
+         */
+        inline std::vector <iThembaParticle> GetParticles() const { return particleData.GetEntries(); }
+
+        /*!
+         * Get reconstructed particles, without any copy.
+         */
+        inline const iThembaParticleData &GetParticleData() const { return particleData; }
+
     };
 }
 
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "Event/iThembaEvent.h"
+#include "Event/EventBuilder.h"
 
 #include <Parser/Entry.h>
 
@@ -17,13 +18,30 @@ namespace Event {
 
     public:
 
+        //! Constructor.
+        explicit iThembaEventBuilder(const DetectorType &trigger=DetectorType::eDet, const double &event_time=1500)
+            : builder( trigger, event_time ), head( 0 ){}
+
         std::vector<iThembaEvent> BuildEvents(std::vector<Parser::Entry_t> &entries);
 
         std::vector<iThembaEvent> FlushEvents();
 
     private:
 
+        //! Sliding window event builder.
+        EventBuilder builder;
+
+        //! Time ordered entries. Entries before head have already been processed.
         std::vector<Parser::Entry_t> entry_buffer;
+
+        //! Index of the first entry not yet processed.
+        size_t head;
+
+        //! Events found in the last call.
+        std::vector<EventRange> ranges;
+
+        //! Build events from the entries after head.
+        std::vector<iThembaEvent> Build(const bool &flush);
     };
 
 }
@@ -3,17 +3,41 @@
 
 #include <Parser/Entry.h>
 
+#include <string>
+#include <cstddef>
+
+class Parameter;
+
 bool SetCalibration(const char *calfile);
 
+//! Write the current calibration to file, in the same format as read by SetCalibration().
+bool WriteCalibration(const char *calfile);
+
+//! Get a calibration parameter by name, nullptr if no such parameter exists.
+Parameter *GetCalibrationParameter(const std::string &name);
+
 //Parser::Entry_t &CalibrateCFD(Parser::Entry_t &detector);
 
 //Parser::Entry_t &CalibrateEnergy(Parser::Entry_t &detector);
 
-//Parser::Entry_t &CalibrateTime(Parser::Entry_t &detector);
+//! Calibrate the timestamp and CFD correction of an entry.
+Parser::Entry_t &CalibrateTime(Parser::Entry_t &detector);
+
+//! Calibrate the energy of a list of entries.
+void CalibrateEnergy(Parser::Entry_t *entries, const size_t &size);
 
 Parser::Entry_t &Calibrate(Parser::Entry_t &evt);
 
 bool CheckTimeGateAddback(const double &timediff);
 
+//! Check if the time difference between a dE hit and an E hit, t_dE - t_E, is within the particle time gate.
+bool CheckTimeGateParticle(const double &timediff);
+
+//! Check if the particle time gate has been set, the default gate [0,0] accepts close to nothing.
+bool HasTimeGateParticle();
+
+//! Get the scattering angle of a dE ring [deg].
+double GetRingAngle(const int &ring);
+
 
 #endif // CALIBRATION_H
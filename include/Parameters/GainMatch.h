@@ -0,0 +1,56 @@
+#ifndef GAINMATCH_H
+#define GAINMATCH_H
+
+#include <Parser/Entry.h>
+#include <Utilities/Histogram.h>
+
+#include <vector>
+
+/*!
+ * Automatic energy gain matching of all detectors. Raw energy spectra
+ * are accumulated per channel with the same binning as the energy_*
+ * spectra of the HistManager. The most prominent peaks of each channel
+ * are then matched either to a list of known source lines, or to the
+ * calibrated position of the same peaks in a reference channel of the
+ * same detector type. The gain_* and shift_* parameters are fitted to
+ * the matched peaks.
+ */
+class GainMatch {
+
+private:
+
+    //! Raw energy spectra of each detector type.
+    Histogram2D energy_ring, energy_sect, energy_back, energy_labrL, energy_labrS, energy_labrF, energy_clover;
+
+    //! Known source lines [keV]. If empty the reference channel is used.
+    std::vector<double> lines;
+
+    //! Reference channel of each detector type.
+    int reference;
+
+    //! Spectra below this channel are ignored when searching for peaks.
+    int threshold;
+
+    //! Get the energy spectra for an entry, nullptr if the entry is not gain matched.
+    Histogram2D *GetHistogram(const Parser::Entry_t &entry, int &id);
+
+    //! Gain match a single detector type, returns number of channels gain matched.
+    int Match(const Histogram2D &hist, const char *gain_name, const char *shift_name);
+
+public:
+
+    //! Constructor.
+    explicit GainMatch(const std::vector<double> &source_lines, /*!< Known source lines [keV].         */
+                       const int &ref_channel=0,                /*!< Reference channel of each type.    */
+                       const int &threshold_channel=100         /*!< Lowest channel included in search. */);
+
+    //! Accumulate the raw energy of a list of entries.
+    void Fill(const std::vector<Parser::Entry_t> &entries);
+
+    //! Find the peaks and update the energy calibration parameters.
+    /*! \return number of channels gain matched.
+     */
+    int Solve();
+};
+
+#endif // GAINMATCH_H
@@ -52,6 +52,11 @@ public:
     //! Deregister from the parameter list.
     ~Parameter();
 
+    //! Obtain the name of the parameter.
+    /*! \return The name the parameter is registered with. */
+    const std::string &GetName() const
+        { return name; }
+
     //! Obtain the size of the list.
     /*! \return The list's size. */
     int GetSize() const
@@ -149,6 +154,12 @@ public:
      */
     bool SetAll(std::istringstream& icmd /*!< The parameter description to read. */);
 
+    //! Write all parameters as text.
+    /*! The parameters are written one per line in the same format
+     *  as read by SetAll().
+     */
+    void Write(std::ostream& out /*!< The stream to write to. */) const;
+
 private:
     //! The map type used by this class.
     typedef std::map<std::string, Parameter*> names_t;
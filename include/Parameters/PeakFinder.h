@@ -0,0 +1,48 @@
+#ifndef PEAKFINDER_H
+#define PEAKFINDER_H
+
+#include <cstdint>
+
+/*!
+ * Functions to locate peaks in the light weight in-memory
+ * spectra used by the automatic calibration routines.
+ */
+
+//! Properties of a peak found in a spectrum.
+struct Peak_t {
+    double centroid;    //!< Background subtracted centroid of the peak.
+    double fwhm;        //!< Full width at half maximum.
+    double area;        //!< Background subtracted number of counts in the peak.
+};
+
+//! Find the most prominent peak in a spectrum.
+/*! The maximum bin is located first, then the FWHM is found by walking
+ *  down to half the maximum on each side. The centroid is the mean of the
+ *  region within one FWHM of the maximum, where a flat background estimated
+ *  from the neighbouring regions on each side has been subtracted.
+ *  \return true if a peak with at least min_area counts was found.
+ */
+bool FindPeak(const uint32_t *counts,   /*!< Spectrum to search.                      */
+              const int &nbins,         /*!< Number of bins in the spectrum.          */
+              const double &xmin,       /*!< Lower edge of the first bin.             */
+              const double &width,      /*!< Bin width.                               */
+              Peak_t &peak,             /*!< Will contain the peak if found.          */
+              const double &min_area=50 /*!< Minimum number of counts in the peak.    */);
+
+//! Find the most prominent peaks in a spectrum.
+/*! Peaks are found one at a time with FindPeak(), each time masking
+ *  out the region of the peak found before searching for the next.
+ *  Bins below first_bin are ignored, such that noise near threshold
+ *  is not mistaken for peaks.
+ *  \return number of peaks found. The peaks are sorted by centroid.
+ */
+int FindPeaks(const uint32_t *counts,   /*!< Spectrum to search.                      */
+              const int &nbins,         /*!< Number of bins in the spectrum.          */
+              const double &xmin,       /*!< Lower edge of the first bin.             */
+              const double &width,      /*!< Bin width.                               */
+              Peak_t *peaks,            /*!< Array to store the peaks found.          */
+              const int &max_peaks,     /*!< Number of peaks to look for.             */
+              const int &first_bin=0,   /*!< First bin to include in the search.      */
+              const double &min_area=50 /*!< Minimum number of counts in a peak.      */);
+
+#endif // PEAKFINDER_H
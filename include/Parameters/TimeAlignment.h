@@ -0,0 +1,60 @@
+#ifndef TIMEALIGNMENT_H
+#define TIMEALIGNMENT_H
+
+#include <Parser/Entry.h>
+#include <Parameters/experimentsetup.h>
+#include <Utilities/Histogram.h>
+
+#include <vector>
+
+/*!
+ * Automatic time alignment of all detectors. Time differences
+ * between the reference detector (by default LaBr F 0, the same reference
+ * as the alignment spectra filled by the HistManager) and every other entry
+ * within the time window are accumulated per channel. The prompt peak
+ * of each channel is located and the shift_t_* parameters are adjusted
+ * such that all prompt peaks end up at zero.
+ */
+class TimeAlignment {
+
+private:
+
+    //! Alignment spectra of each detector type, same binning as the HistManager.
+    Histogram2D time_ring, time_sect, time_back, time_labrL, time_labrS, time_labrF, time_clover;
+
+    //! Maximum time difference between the reference and an entry.
+    double window;
+
+    //! Detector type of the reference detector.
+    DetectorType reference_type;
+
+    //! Detector number of the reference detector.
+    int reference_num;
+
+    //! Number of reference entries found.
+    size_t reference_count;
+
+    //! Get the alignment spectra for an entry, nullptr if the entry is not aligned.
+    Histogram2D *GetHistogram(const Parser::Entry_t &entry, int &id);
+
+    //! Align a single detector type, returns number of channels aligned.
+    int Align(const Histogram2D &hist, const char *param_name);
+
+public:
+
+    //! Constructor.
+    explicit TimeAlignment(const double &time_window=1500,              /*!< Time window around the reference [ns].    */
+                           const DetectorType &ref_type=labr_2x2_fs,    /*!< Detector type of the reference.           */
+                           const int &ref_num=0                         /*!< Detector number of the reference.         */);
+
+    //! Accumulate time differences from a list of time ordered entries.
+    void Fill(const std::vector<Parser::Entry_t> &entries);
+
+    //! Find the prompt peaks and update the time calibration parameters.
+    /*! \return number of channels aligned.
+     *  \throws std::runtime_error if the reference detector had no entries.
+     */
+    int Solve();
+};
+
+#endif // TIMEALIGNMENT_H
@@ -16,6 +16,8 @@
 
 #define TOTAL_NUMBER_OF_ADDRESSES 545   //! Total number of address that needs to be defined
 
+#define ALL_DETECTOR_TYPES 0xFFFFFFFFu  //! Detector type mask with all types set
+
 enum DetectorType {
     invalid,        //!< Invalid address
     labr_3x8,       //!< Is a 3.5x8 inch labr detector
@@ -64,6 +66,20 @@ enum DetectorType GetDetectorType(const uint16_t &address   /*!< Address of the
  */
 enum ADCSamplingFreq GetSamplingFrequency(const uint16_t &address    /*!< ADC address    */);
 
+//! Get the detector ID of an address, as numbered in the events
+/*!
+ * \return The detector number, for the clover crystals
+ *  detectorNum*NUM_CLOVER_CRYSTALS + telNum.
+ */
+int16_t GetFlatID(const uint16_t &address    /*!< ADC address of the entry */);
+
+//! Get the detector types in use
+/*!
+ * \return Mask where bit n is set if at least one address
+ *  of the address map is of detector type n.
+ */
+unsigned GetPresentTypes();
+
 
 
 #endif // EXPERIMENTSETUP_H
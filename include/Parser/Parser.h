@@ -36,6 +36,12 @@ namespace Parser {
          */
         virtual std::vector<Entry_t> GetEntry(const Fetcher::Buffer *buffer) = 0;
 
+        /*!
+         * Forget any state kept from the buffers parsed so far,
+         * such that the next buffer is parsed as the start of a new stream.
+         */
+        virtual void Reset(){}
+
         //! No-op destructor
         virtual ~Base() = default;
 
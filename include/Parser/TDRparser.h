@@ -26,6 +26,9 @@ namespace Parser {
          */
         std::vector<Entry_t> GetEntry(const Fetcher::Buffer *new_buffer) override;
 
+        //! Forget the top timestamp and the entries left over from the previous buffers.
+        void Reset() override { top_time = -1; leftover_entries.clear(); }
+
     private:
 
         //! Top 32-bit of the timestamp
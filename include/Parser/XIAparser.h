@@ -30,6 +30,9 @@ namespace Parser {
          */
         std::vector<Entry_t> GetEntry(const Fetcher::Buffer *new_buffer) override;
 
+        //! Forget any event split across the previous buffers.
+        void Reset() override { spill_buffer.clear(); }
+
     private:
 
         //! A buffer in cases where an event is split across two actual buffers
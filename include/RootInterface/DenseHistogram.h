@@ -0,0 +1,48 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef DENSEHISTOGRAM_H
+#define DENSEHISTOGRAM_H
+
+#include <Utilities/Histogram.h>
+
+class TH2;
+
+/*!
+ * A ROOT 2D histogram filled through a native counter array.
+ * The binning is taken from the axes of the ROOT histogram and the
+ * counts are kept in a Histogram2D owned by the filling thread. The
+ * counts are only added to the ROOT histogram when flushed, such that
+ * the per entry cost is a range check and an increment. Entries outside
+ * the axis ranges are ignored rather than put in under/overflow bins.
+ */
+class DenseTH2 {
+
+private:
+
+    TH2 *hist;              //!< ROOT histogram receiving the counts.
+    Histogram2D counts;     //!< Counts not yet added to the ROOT histogram.
+    size_t entries;         //!< Number of entries not yet added to the ROOT histogram.
+
+public:
+
+    //! Constructor.
+    explicit DenseTH2(TH2 *hist     /*!< ROOT histogram to fill, binning is copied from its axes. */);
+
+    //! Fill an entry.
+    inline void Fill(const double &x, const double &y)
+    {
+        counts.FillXY(x, y);
+        ++entries;
+    }
+
+    //! Add the counts to the ROOT histogram and reset the counters.
+    void Flush();
+
+    //! Get the ROOT histogram.
+    TH2 *GetHistogram(){ return hist; }
+
+};
+
+#endif // DENSEHISTOGRAM_H
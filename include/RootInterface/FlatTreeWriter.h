@@ -0,0 +1,45 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef FLATTREEWRITER_H
+#define FLATTREEWRITER_H
+
+#include "FlatWriter.h"
+#include "RootFileManager.h"
+
+class TTree;
+
+/*!
+ * Flat columns written as a tree with one scalar branch per column, one tree entry per hit.
+ * The compression and basket settings of the file manager are used.
+ */
+class FlatTreeWriter : public FlatWriter {
+
+private:
+
+    TTree *tree;        //!< Tree to fill.
+
+    uint16_t address;   //!< Address of the current entry.
+    int16_t ID;         //!< Detector ID of the current entry.
+    uint8_t type;       //!< Detector type of the current entry.
+    uint16_t e_raw;     //!< Raw energy of the current entry.
+    double energy;      //!< Calibrated energy of the current entry.
+    int64_t tcoarse;    //!< Timestamp of the current entry.
+    double tfine;       //!< CFD correction of the current entry.
+    bool cfdfail;       //!< CFD fail flag of the current entry.
+    bool pileup;        //!< Pile-up flag of the current entry.
+
+public:
+
+    //! Constructor.
+    FlatTreeWriter(RootFileManager *fm,     /*!< File to write the tree to. */
+                   const char *name,        /*!< Name of the tree.          */
+                   const char *title        /*!< Title of the tree.         */);
+
+    //! Write a batch of entries.
+    void Write(const Parser::Entry_t *entries, const size_t &size) override;
+
+};
+
+#endif // FLATTREEWRITER_H
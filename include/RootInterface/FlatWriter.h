@@ -0,0 +1,90 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef FLATWRITER_H
+#define FLATWRITER_H
+
+#include <Parser/Entry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*!
+ * Output of the entries as flat columns, one row per hit, without event building.
+ * \details The columns are address, ID, type, e_raw, energy, tcoarse, tfine,
+ * cfdfail and pileup. The ID is the detector number, for the clover crystals
+ * numbered as in the events.
+ */
+class FlatWriter {
+
+public:
+
+    //! Destructor.
+    virtual ~FlatWriter() = default;
+
+    //! Write a batch of entries.
+    virtual void Write(const Parser::Entry_t *entries,  /*!< Entries to write   */
+                       const size_t &size               /*!< Number of entries  */) = 0;
+
+};
+
+/*!
+ * Flat columns written as raw binary arrays, one file per column.
+ * \details The column files are named <base>.<column> and contain the values
+ * in native byte order without any header. A text file <base>.columns lists
+ * the name, type and number of values of each column, such that each column
+ * can be memory mapped directly (e.g. numpy.memmap). The entries are buffered
+ * and written in batches.
+ */
+class FlatBinaryWriter : public FlatWriter {
+
+private:
+
+    //! A column file.
+    struct Column_t {
+        const char *name;   //!< Name of the column.
+        const char *type;   //!< Type of the values (numpy notation).
+        FILE *file;         //!< File the column is written to.
+    };
+
+    std::string base;               //!< Base name of the files.
+    std::vector<Column_t> columns;  //!< Column files.
+    size_t rows;                    //!< Number of rows written.
+
+    std::vector<uint16_t> address;  //!< Buffered addresses.
+    std::vector<int16_t> ID;        //!< Buffered detector ID's.
+    std::vector<uint8_t> type;      //!< Buffered detector types.
+    std::vector<uint16_t> e_raw;    //!< Buffered raw energies.
+    std::vector<double> energy;     //!< Buffered calibrated energies.
+    std::vector<int64_t> tcoarse;   //!< Buffered timestamps.
+    std::vector<double> tfine;      //!< Buffered CFD corrections.
+    std::vector<uint8_t> cfdfail;   //!< Buffered CFD fail flags.
+    std::vector<uint8_t> pileup;    //!< Buffered pile-up flags.
+
+    //! Write the buffered entries to the column files.
+    void Flush();
+
+public:
+
+    //! Number of entries buffered before the columns are written.
+    static const size_t batch_size = 1 << 16;
+
+    //! Create the column files.
+    /*!
+     * \throws std::runtime_error if a file can't be opened.
+     */
+    explicit FlatBinaryWriter(const char *base_name  /*!< Base name of the files */);
+
+    //! Destructor. Writes the remaining entries and the column list.
+    ~FlatBinaryWriter() override;
+
+    //! Write a batch of entries.
+    void Write(const Parser::Entry_t *entries, const size_t &size) override;
+
+};
+
+#endif // FLATWRITER_H
@@ -22,64 +22,78 @@
 #define HISTMANAGER_H
 
 #include "RootFileManager.h"
+#include "DenseHistogram.h"
+#include "HistogramDefinition.h"
 
 #include <vector>
 
 #include <Event/iThembaEvent.h>
 
 
+/*!
+ * Spectra filled from the events.
+ * \details The per hit spectra are given by a list of definitions, compiled
+ * into a fill plan grouped by detector type. Each hit is visited once and
+ * filled into all spectra of its detector type.
+ */
 class HistManager {
 
 private:
 
-    //! Time spectra for each detector
-    TH2 *time_ring;     //!< Alignment spectra of dE rings.
-    TH2 *time_sect;     //!< Alignment spectra of dE sectors.
-    TH2 *time_back;     //!< Alignment spectra of dE back detectors.
-    TH2 *time_labrL;    //!< Alignment spectra of large LaBr detectors.
-    TH2 *time_labrS;    //!< Alignment spectra of small LaBr detectors (slow signal).
-    TH2 *time_labrF;    //!< Alignment spectra of small LaBr detectors (fast signal).
-    TH2 *time_clover;   //!< Alignment spectra of clover crystals.
-
-    //! Time energy spectra for particles.
-    TH2 *time_energy_sect_back;
-    TH2 *time_energy_ring_sect;
-
-    //! Energy spectra for each detector.
-    TH2 *energy_ring;
-    TH2 *energy_sect;
-    TH2 *energy_back;
-    TH2 *energy_labrL;
-    TH2 *energy_labrS;
-    TH2 *energy_labrF;
-    TH2 *energy_clover;
-
-    TH2 *energy_cal_ring;
-    TH2 *energy_cal_sect;
-    TH2 *energy_cal_back;
-    TH2 *energy_cal_labrL;
-    TH2 *energy_cal_labrS;
-    TH2 *energy_cal_labrF;
-    TH2 *energy_cal_clover;
+    //! A single fill operation of the plan.
+    struct FillStep {
+        HistogramDefinition::Axis axis;     //!< Quantity on the x-axis.
+        size_t reference;                   //!< Index of the time reference, only used for time spectra.
+        double gate_low;                    //!< Lower limit of the energy gate.
+        double gate_high;                   //!< Upper limit of the energy gate, no gate if not above gate_low.
+        size_t hist;                        //!< Index of the spectrum to fill.
+    };
+
+    //! A time reference detector.
+    struct Reference {
+        DetectorType type;                  //!< Detector type of the reference.
+        int ID;                             //!< ID of the reference, ignored for the RF.
+        std::vector<std::pair<int64_t, double> > times;    //!< Times of the reference in the current event.
+    };
+
+    std::vector<DenseTH2> hists;                    //!< Spectra from the definitions.
+    std::vector<DetectorType> types;                //!< Detector types with at least one fill step.
+    std::vector<FillStep> plan[unused + 1];         //!< Fill steps for each detector type.
+    std::vector<Reference> references;              //!< Time references used by the time spectra.
 
     TH2 *addback_hist;
 
-    void FillTDiff(const Event::iThembaEntry &start, const std::vector<Event::iThembaEntry> &stop, TH2 *time);
-    void FillEnergy(const std::vector<Event::iThembaEntry> &entries, TH2 *hist, TH2 *hist_cal);
+    //! Energy spectra of the clover detectors after addback.
+    DenseTH2 energy_addback_clover;
+
+    //! dE-E spectrum of the reconstructed particles.
+    DenseTH2 ede_particle;
+
+    //! Create the spectra and compile the fill plan.
+    template<class FileManager>
+    void Setup(FileManager *fm, const std::vector<HistogramDefinition> &definitions);
 
 public:
 
     //! Constructor.
-    explicit HistManager(RootFileManager *fileManager    /*!< ROOT file where the histograms will reside.    */);
+    explicit HistManager(RootFileManager *fileManager,   /*!< ROOT file where the histograms will reside.    */
+                         const std::vector<HistogramDefinition> &definitions = DefaultHistograms()  /*!< Per hit spectra. */);
 
 #if ROOT_MT_FLAG
     //! Constructor.
-    explicit HistManager(RootMergeFileManager *fileManager    /*!< ROOT file where the histograms will reside.    */);
+    explicit HistManager(RootMergeFileManager *fileManager,  /*!< ROOT file where the histograms will reside.    */
+                         const std::vector<HistogramDefinition> &definitions = DefaultHistograms()  /*!< Per hit spectra. */);
 #endif // ROOT_MT_FLAG
 
     //! Fill spectra with an event.
     void AddEntry(const Event::iThembaEvent &event  /*!< Event to read from    */);
 
+    //! Fill addback spectra with an event where the addback has been done.
+    void AddAddback(const Event::iThembaEvent &event  /*!< Event to read from    */);
+
+    //! Add the counts filled so far to the ROOT histograms. Must be called before the file is written.
+    void Flush();
+
     //! Get addback histogram.
     TH2 *GetAB() { return addback_hist; }
 };
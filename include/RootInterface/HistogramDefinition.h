@@ -0,0 +1,70 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef HISTOGRAMDEFINITION_H
+#define HISTOGRAMDEFINITION_H
+
+#include <Parameters/experimentsetup.h>
+
+#include <string>
+#include <vector>
+
+/*!
+ * Definition of a spectrum filled with one entry per hit of a detector type.
+ * The y-axis is the ID of the detector, the x-axis the raw energy, the
+ * calibrated energy or the time relative to a reference detector.
+ */
+struct HistogramDefinition {
+
+    //! Quantity on the x-axis.
+    enum Axis {
+        axis_e_raw,     //!< Raw energy [ch].
+        axis_energy,    //!< Calibrated energy [keV].
+        axis_time       //!< Time relative to the reference detector [ns].
+    };
+
+    std::string name;           //!< Name of the histogram.
+    std::string title;          //!< Title of the histogram.
+    DetectorType detector;      //!< Detector type filling the histogram.
+    Axis axis;                  //!< Quantity on the x-axis.
+    DetectorType reference;     //!< Detector type of the time reference, only used for time spectra.
+    int reference_id;           //!< ID of the time reference detector.
+    double gate_low;            //!< Lower limit of the calibrated energy gate.
+    double gate_high;           //!< Upper limit of the calibrated energy gate, no gate if not above gate_low.
+    int xbins;                  //!< Number of bins on the x-axis.
+    double xmin;                //!< Lower limit of the first bin on the x-axis.
+    double xmax;                //!< Upper limit of the last bin on the x-axis.
+    std::string xtitle;         //!< Title of the x-axis.
+    int ybins;                  //!< Number of detector ID's on the y-axis.
+    std::string ytitle;         //!< Title of the y-axis.
+};
+
+//! Get the spectra made when no definition file is given.
+std::vector<HistogramDefinition> DefaultHistograms();
+
+//! Read histogram definitions from a file.
+/*!
+ * Each histogram is a section of the file, the name of the section is the
+ * name of the histogram. Example:
+ *
+ *     [time_labrL]
+ *     title = Time spectra LaBr L
+ *     detector = labr_3x8
+ *     axis = time
+ *     reference = labr_2x2_fs 0
+ *     gate = 100 5000
+ *     xbins = 3000
+ *     xmin = -1500
+ *     xmax = 1500
+ *
+ * The axis is one of e_raw, energy or time. The reference and the gate are
+ * optional, the reference defaults to labr_2x2_fs 0. The ID is ignored when
+ * the RF (rfchan) is the reference. The number of bins on the
+ * y-axis defaults to the number of detectors of the type. Any other key is an error.
+ * \return The definitions in the file, in the order of the file.
+ * \throws std::runtime_error if the file can't be read or a definition is invalid.
+ */
+std::vector<HistogramDefinition> ReadHistograms(const char *filename    /*!< File to read */);
+
+#endif // HISTOGRAMDEFINITION_H
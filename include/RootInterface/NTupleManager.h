@@ -0,0 +1,72 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef NTUPLEMANAGER_H
+#define NTUPLEMANAGER_H
+
+#include "RootOutputOptions.h"
+
+#include <memory>
+
+namespace Event {
+    class iThembaEvent;
+}
+
+/*!
+ * RNTuple output of the events, an alternative to the tree.
+ * \details Each detector type of the event is stored as one collection field
+ * per quantity, named as the branches of the tree (e.g. ringID, ringEnergy).
+ * The writer is shared by all filler threads, each thread fills through its
+ * own NTupleManager. Only available when built with ENABLE_RNTUPLE, otherwise
+ * the constructor throws.
+ */
+class NTupleWriter
+{
+
+private:
+
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+
+    friend class NTupleManager;
+
+public:
+
+    //! Create the file and the RNTuple.
+    /*!
+     * \throws std::runtime_error if built without RNTuple support.
+     */
+    NTupleWriter(const char *fname,                 /*!< File to write to.                  */
+                 const char *name,                  /*!< Name of the RNTuple.               */
+                 const RootOutputOptions &options,  /*!< Compression of the output.         */
+                 const bool &particles              /*!< Store the reconstructed particles. */);
+
+    //! Destructor. Commits the RNTuple, all managers must be destroyed first.
+    ~NTupleWriter();
+
+};
+
+//! Fills events into a shared NTupleWriter from one thread.
+class NTupleManager
+{
+
+private:
+
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+
+public:
+
+    //! Constructor.
+    explicit NTupleManager(NTupleWriter *writer     /*!< Writer to fill to. */);
+
+    //! Destructor. Sends the last cluster to the writer.
+    ~NTupleManager();
+
+    //! Add an event.
+    void AddEntry(const Event::iThembaEvent &event  /*!< Event to add. */);
+
+};
+
+#endif // NTUPLEMANAGER_H
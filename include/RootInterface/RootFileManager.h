@@ -21,6 +21,8 @@
 #ifndef ROOTFILEMANAGER_H
 #define ROOTFILEMANAGER_H
 
+#include "RootOutputOptions.h"
+
 #include <TFile.h>
 
 #include <memory>
@@ -48,12 +50,17 @@ private:
 
     TFile file;                         //!< File where everything will be put in.
     std::vector<TObject *> list;        //!< List to store ROOT objects.
+    RootOutputOptions options;          //!< Compression and tree settings.
 
 
 public:
 
     //! Construct and open.
-    explicit RootFileManager(const char *fname, const char *mode="RECREATE", const char *ftitle="");
+    explicit RootFileManager(const char *fname, const char *mode="RECREATE", const char *ftitle="",
+                             const RootOutputOptions &options=DefaultOutputOptions());
+
+    //! Get the compression and tree settings.
+    const RootOutputOptions &GetOptions() const { return options; }
 
     //! Close file
     void Close(){
@@ -115,14 +122,28 @@ private:
 
     std::shared_ptr<ROOT::Experimental::TBufferMergerFile> file;
     std::vector<TObject *> list;        //!< List to store ROOT objects.
+    RootOutputOptions options;          //!< Tree settings, the compression is set by the merger.
 
 public:
 
-    explicit RootMergeFileManager(ROOT::Experimental::TBufferMerger *bm);
+    //! Constructor. Gets a new memory file from the merger.
+    explicit RootMergeFileManager(ROOT::Experimental::TBufferMerger *bm,
+                                  const RootOutputOptions &options=DefaultOutputOptions());
 
-    //! Destructor.
+    //! Get the compression and tree settings.
+    const RootOutputOptions &GetOptions() const { return options; }
+
+    //! Destructor. Sends the remaining content to the merger.
     ~RootMergeFileManager();
 
+    //! Send the content filled so far to the merger.
+    /*!
+     * The tree baskets and the histograms are written to the memory file and
+     * queued for merging into the output file. The memory held by the thread is
+     * released, such that it is bounded by the amount filled between calls.
+     */
+    void Write();
+
     //! Create a ROOT tree object.
     /*!
      *
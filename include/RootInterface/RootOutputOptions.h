@@ -0,0 +1,48 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef ROOTOUTPUTOPTIONS_H
+#define ROOTOUTPUTOPTIONS_H
+
+#include <string>
+#include <cstdint>
+
+#include "Event/StorageOptions.h"
+
+//! Settings of the ROOT output files and trees. Zero (or negative compression) keeps the ROOT default.
+struct RootOutputOptions {
+    int compression;        //!< ROOT compression setting, 100*algorithm + level, see ParseCompression.
+    int basket_size;        //!< Basket size of each branch [bytes].
+    long long autoflush;    //!< Auto flush of the trees. Entries if positive, bytes if negative (see TTree::SetAutoFlush).
+    long long autosave;     //!< Auto save of the trees. Entries if positive, bytes if negative (see TTree::SetAutoSave).
+    Event::StorageOptions storage;  //!< Precision of the hits stored in the trees.
+};
+
+//! Get the ROOT default output options.
+inline RootOutputOptions DefaultOutputOptions(){ return {-1, 0, 0, 0, Event::FullPrecision()}; }
+
+//! Size of each shard of the output tree. Zero means no limit.
+struct ShardLimits {
+    long long events;   //!< Max. number of events in a shard.
+    long long bytes;    //!< Max. size of a shard [bytes], compressed.
+    int64_t time;       //!< Max. beam time covered by a shard [ns].
+};
+
+//! Get limits with sharding disabled.
+inline ShardLimits NoShards(){ return {0, 0, 0}; }
+
+//! Check if any of the limits are set.
+inline bool IsSharded(const ShardLimits &limits){ return limits.events > 0 || limits.bytes > 0 || limits.time > 0; }
+
+//! Convert a compression given as text to a ROOT compression setting.
+/*!
+ * The text is an algorithm (zlib, lzma, lz4, zstd or none) optionally
+ * followed by a colon and a level from 1 to 9, e.g. "lz4" or "zstd:7".
+ * Without a level the level recommended by ROOT for the algorithm is used.
+ * \return The compression setting, 100*algorithm + level.
+ * \throws std::invalid_argument if the text isn't understood.
+ */
+int ParseCompression(const std::string &text  /*!< Compression to convert */);
+
+#endif // ROOTOUTPUTOPTIONS_H
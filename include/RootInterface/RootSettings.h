@@ -0,0 +1,23 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef ROOTSETTINGS_H
+#define ROOTSETTINGS_H
+
+#include "HistogramDefinition.h"
+#include "NTupleManager.h"
+#include "RootOutputOptions.h"
+
+#include <memory>
+#include <vector>
+
+//! Settings of the ROOT output of the converter.
+struct RootSettings_t {
+    RootOutputOptions options = DefaultOutputOptions();     //!< Compression and basket settings of the output
+    ShardLimits shards = NoShards();                        //!< When the output tree is split into a new file
+    std::unique_ptr<NTupleWriter> ntuple;                   //!< RNTuple output of the events, null if none
+    std::vector<HistogramDefinition> histograms = DefaultHistograms();  //!< Per hit spectra to fill
+};
+
+#endif // ROOTSETTINGS_H
@@ -0,0 +1,83 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef SHARDMANAGER_H
+#define SHARDMANAGER_H
+
+#include "RootFileManager.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * Splits the output tree into a series of files, named <base>_shardNNNN.root.
+ * A new shard is started when the current one reaches any of the limits.
+ * When done a manifest, <base>_shards.txt, is written with the file name,
+ * number of events and the time range of each shard.
+ */
+class ShardManager
+{
+
+private:
+
+    struct Shard_t {
+        std::string name;       //!< File name of the shard.
+        long long entries;      //!< Number of events in the shard.
+        long long bytes;        //!< Compressed size of the tree.
+        int64_t first_time;     //!< Timestamp of the first event.
+        int64_t last_time;      //!< Timestamp of the last event.
+    };
+
+    std::string base;                       //!< Output name without the .root suffix.
+    RootOutputOptions options;              //!< Compression and tree settings of each shard.
+    ShardLimits limits;                     //!< When to start a new shard.
+    std::unique_ptr<RootFileManager> file;  //!< File of the current shard.
+    std::vector<Shard_t> shards;            //!< All shards so far, the last is the current.
+
+public:
+
+    //! Constructor. The first shard is opened by Next.
+    ShardManager(const char *fname,                 /*!< Output file name, the shards are named after it.  */
+                 const RootOutputOptions &options,  /*!< Compression and tree settings of the shards.      */
+                 const ShardLimits &limits          /*!< When to start a new shard.                        */);
+
+    //! Destructor. Closes the last shard and writes the manifest.
+    ~ShardManager();
+
+    //! Check if a new shard has to be started before an event.
+    inline bool IsFull(const int64_t &time) const
+    {
+        if ( shards.empty() )
+            return true;
+        const Shard_t &shard = shards.back();
+        return ( limits.events > 0 && shard.entries >= limits.events ) ||
+               ( limits.bytes > 0 && shard.bytes >= limits.bytes ) ||
+               ( limits.time > 0 && shard.entries > 0 && time - shard.first_time >= limits.time );
+    }
+
+    //! Close the current shard and open the next.
+    /*!
+     * \return The file of the new shard.
+     */
+    RootFileManager *Next();
+
+    //! Count an event filled to the tree of the current shard.
+    /*!
+     * \param time Timestamp of the event.
+     * \param bytes Compressed size of the tree so far.
+     */
+    inline void Add(const int64_t &time, const long long &bytes)
+    {
+        Shard_t &shard = shards.back();
+        if ( shard.entries++ == 0 )
+            shard.first_time = time;
+        shard.last_time = time;
+        shard.bytes = bytes;
+    }
+
+};
+
+#endif // SHARDMANAGER_H
@@ -23,6 +23,7 @@
 
 #include <Buffer/aptr.h>
 #include "RootFileManager.h"
+#include "ShardManager.h"
 #include "Event/Event.h"
 
 #include <TTree.h>
@@ -36,21 +37,88 @@ protected:
     TTree *tree;            //!< Pointer to the tree to write events to.
     Event::Base *entry_obj; //!< Object to fill (set at run time
 
+    ShardManager *shards;   //!< Files the tree is split into, null if not sharded.
+    std::string name;       //!< Name of the tree in each shard.
+    std::string title;      //!< Title of the tree in each shard.
+    unsigned types;         //!< Detector types with branches in each shard.
+
+    //! Close the current shard and set up the tree in the next.
+    void NextShard();
+
+#if ROOT_MT_FLAG
+    RootMergeFileManager *merge_file;   //!< Merger file the tree is sent to, null if not merged.
+    long long unmerged_bytes;           //!< Bytes filled since the tree was last sent to the merger.
+#endif // ROOT_MT_FLAG
+
 public:
 
-    TreeManager(RootFileManager *fm, const char *name, const char *title, Event::Base *type)
+#if ROOT_MT_FLAG
+    //! Number of (uncompressed) bytes a thread fills before it is sent to the merger.
+    static const long long merge_bytes = 64*1024*1024;
+#endif // ROOT_MT_FLAG
+
+    /*!
+     * Tree written to a file.
+     * Only the components of the event with a detector type in types get branches.
+     */
+    TreeManager(RootFileManager *fm, const char *name, const char *title, Event::Base *type,
+                const unsigned &types = ALL_DETECTOR_TYPES)
         : tree( fm->CreateTree(name, title) )
         , entry_obj( type )
+        , shards( nullptr )
+        , types( types )
+#if ROOT_MT_FLAG
+        , merge_file( nullptr )
+        , unmerged_bytes( 0 )
+#endif // ROOT_MT_FLAG
         {
-            entry_obj->SetupTree(tree);
+            entry_obj->SetStorage(fm->GetOptions().storage);
+            entry_obj->SetupTree(tree, types);
+            if ( fm->GetOptions().basket_size > 0 )
+                tree->SetBasketSize("*", fm->GetOptions().basket_size);
         }
 
+    /*!
+     * Tree split into shards. The first shard is opened by the first event,
+     * such that no files are written if the tree isn't filled.
+     */
+    TreeManager(ShardManager *sm, const char *name, const char *title, Event::Base *type,
+                const unsigned &types = ALL_DETECTOR_TYPES)
+        : tree( nullptr )
+        , entry_obj( type )
+        , shards( sm )
+        , name( name )
+        , title( title )
+        , types( types )
+#if ROOT_MT_FLAG
+        , merge_file( nullptr )
+        , unmerged_bytes( 0 )
+#endif // ROOT_MT_FLAG
+        {}
+
 #if ROOT_MT_FLAG
-    TreeManager(RootMergeFileManager *fm, const char *name, const char *title, Event::Base *type)
+    /*!
+     * Tree filled by one of several threads and merged into a single file.
+     * The content is sent to the merger every merge_bytes, keeping the memory
+     * of each thread bounded. Unless given in the options, the auto flush is set
+     * to the same size, such that the clusters are cut when the tree is sent to
+     * the merger rather than by ROOT.
+     */
+    TreeManager(RootMergeFileManager *fm, const char *name, const char *title, Event::Base *type,
+                const unsigned &types = ALL_DETECTOR_TYPES)
             : tree( fm->CreateTree(name, title) )
             , entry_obj( type )
+            , shards( nullptr )
+            , types( types )
+            , merge_file( fm )
+            , unmerged_bytes( 0 )
     {
-        entry_obj->SetupTree(tree);
+        if ( fm->GetOptions().autoflush == 0 )
+            tree->SetAutoFlush(-merge_bytes);
+        entry_obj->SetStorage(fm->GetOptions().storage);
+        entry_obj->SetupTree(tree, types);
+        if ( fm->GetOptions().basket_size > 0 )
+            tree->SetBasketSize("*", fm->GetOptions().basket_size);
     }
 #endif // ROOT_MT_FLAG
 
@@ -61,8 +129,28 @@ public:
 
     inline void AddEntry(Event::Base *entry)
     {
+        if ( shards ){
+            // The branches are moved to the new tree before the event is copied.
+            const int64_t time = entry->GetFirstTime();
+            if ( shards->IsFull(time) )
+                NextShard();
+            entry_obj->Copy(entry);
+            entry_obj->Encode();
+            tree->Fill();
+            shards->Add(time, tree->GetZipBytes());
+            return;
+        }
         entry_obj->Copy(entry);
+        entry_obj->Encode();
+#if ROOT_MT_FLAG
+        unmerged_bytes += tree->Fill();
+        if ( merge_file && unmerged_bytes >= merge_bytes ){
+            merge_file->Write();
+            unmerged_bytes = 0;
+        }
+#else
         tree->Fill();
+#endif // ROOT_MT_FLAG
     }
 };
 
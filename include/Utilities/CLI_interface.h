@@ -13,38 +13,55 @@
 #include <Parser/Entry.h>
 #include <Parameters/experimentsetup.h>
 #include <Event/Event.h>
+#include <Event/EventBuilder.h>
 
 namespace Parser {
     class Base;
 }
 
+struct RootSettings_t;
+
 // External dependencies
 #include <blockingconcurrentqueue.h>
 // Typedefs
 typedef moodycamel::BlockingConcurrentQueue<Parser::Entry_t> Entry_queue_t;
-typedef moodycamel::BlockingConcurrentQueue< std::vector<Parser::Entry_t> > Event_queue_t;
+typedef moodycamel::BlockingConcurrentQueue<Event::EventChunk> Chunk_queue_t;
 typedef moodycamel::BlockingConcurrentQueue<std::string> String_queue_t;
 
+//! Target of the flat per hit output, written without event building.
+enum class FlatOutput {
+    none,       //!< No flat output
+    tree,       //!< Tree with one scalar branch per column
+    binary      //!< One raw binary file per column
+};
+
 struct Settings_t {
-    std::vector<std::string> input_files;   //!< List of all files to read from
-    std::string output_file;                //!< File to write to
-    std::string file_title;                 //!< Title of the output file
-    bool build_tree;                        //!< Flag to indicate output to a tree
-    bool output_csv;                        //!< Flag to indicate output to CSV
-    std::string tree_name;                  //!< Name of the output tree
-    std::string tree_title;                 //!< Title of the output tree
-    Fetcher::Buffer *buffer_type;           //!< Defines the buffer type (and the format)
-    Parser::Base *parser;                   //!< A parser object (defined by the format)
-    Event::Base *event_type;                //!< Type of the event (defined by the format)
-    double split_time;                      //!< Time gap where entries are split
-    double event_time;                      //!< Time where entries are grouped together
-    DetectorType trigger_type;              //!< Detector type acting as "trigger" in event builder
-    Entry_queue_t *input_queue;             //!< Queue with sorted entries from the parser
-    Event_queue_t *split_queue;             //!< Queue with grouped entries after splitting
-    Event_queue_t *built_queue;             //!< Queue with finished built entries
-    String_queue_t *str_queue;              //!< Queue for storing strings to a CSV writer
-    size_t num_split_threads;               //!< Number of splitter threads
-    size_t num_filler_threads;              //!< Number of filler threads
+    std::vector<std::string> input_files;                   //!< List of all files to read from
+    std::string output_file;                                //!< File to write to
+    std::string file_title = "TDR2tree";                    //!< Title of the output file
+    bool build_tree = false;                                //!< Flag to indicate output to a tree
+    bool output_csv = false;                                //!< Flag to indicate output to CSV
+    FlatOutput flat_output = FlatOutput::none;              //!< Flat per hit output, none if events are built
+    std::string tree_name = "events";                       //!< Name of the output tree
+    std::string tree_title = "Events";                      //!< Title of the output tree
+    unsigned tree_types = ALL_DETECTOR_TYPES;               //!< Mask of the detector types that get branches in the tree
+    RootSettings_t *root = nullptr;                         //!< Settings of the ROOT output, owned by the caller
+    Fetcher::Buffer *buffer_type = nullptr;                 //!< Defines the buffer type (and the format)
+    Parser::Base *parser = nullptr;                         //!< A parser object (defined by the format)
+    Event::Base *event_type = nullptr;                      //!< Type of the event (defined by the format)
+    double split_time = 1500;                               //!< Time gap where entries are split
+    double event_time = 1500;                               //!< Time where entries are grouped together
+    DetectorType trigger_type = DetectorType::eDet;         //!< Detector type acting as "trigger" in event builder
+    Event::WindowMode window_mode = Event::fixed_window;    //!< How events are built when the trigger is "any"
+    Event::TriggerCondition *condition = nullptr;           //!< Coincidence condition of the events, null if none
+    bool addback = false;                                   //!< Flag to indicate that clover addback should be done
+    bool particles = false;                                 //!< Flag to indicate that dE-E particles should be reconstructed
+    Entry_queue_t *input_queue = nullptr;                   //!< Queue with sorted entries from the parser
+    Chunk_queue_t *split_queue = nullptr;                   //!< Queue with grouped entries after splitting
+    Chunk_queue_t *built_queue = nullptr;                   //!< Queue with chunks of finished built events
+    String_queue_t *str_queue = nullptr;                    //!< Queue for storing strings to a CSV writer
+    size_t num_split_threads = 2;                           //!< Number of splitter threads
+    size_t num_filler_threads = 1;                          //!< Number of filler threads
 
     ~Settings_t(); // Clean-up
 };
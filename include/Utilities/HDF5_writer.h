@@ -8,69 +8,69 @@
 #include <hdf5.h>
 #include <Parser/Entry.h>
 
+#include <cstddef>
 #include <cstdint>
-
-#define MAX_COLUMNS 512
-
-struct Pointers {
-    uint16_t *dtype;
-    uint16_t *id;
-    uint16_t *adcdata;
-    uint16_t *cfddata;
-    int64_t *timestamp;
-    double *cfdcorr;
-    double *energy;
-    bool *cfdfail;
-    bool *finishcode;
-
-    void setup(char *map, haddr_t *offsets){
-        dtype = (uint16_t *)(map + offsets[0]);
-        id = (uint16_t *)(map + offsets[1]);
-        adcdata = (uint16_t *)(map + offsets[2]);
-        cfddata = (uint16_t *)(map + offsets[3]);
-        timestamp = (int64_t *)(map + offsets[4]);
-        cfdcorr = (double *)(map + offsets[5]);
-        energy = (double *)(map + offsets[6]);
-        cfdfail = (bool *)(map + offsets[7]);
-        finishcode = (bool *)(map + offsets[8]);
-    }
-
-    void reset(){
-        dtype = nullptr;
-        id = nullptr;
-        adcdata = nullptr;
-        cfddata = nullptr;
-        timestamp = nullptr;
-        cfdcorr = nullptr;
-        energy = nullptr;
-        cfdfail = nullptr;
-        finishcode = nullptr;
-    }
-};
-
+#include <vector>
+
+/*!
+ * Writes the entries as columns of the group "data" in a HDF5 file.
+ * \details Each column is a chunked dataset without an upper limit on the
+ * number of rows. The entries are buffered and the datasets are extended by
+ * one chunk at the time, such that the input only has to be read once.
+ */
 class HDF5_Writer {
 
 private:
-    size_t noRows;
-    size_t row_idx; // Current row
-
-    int fd;
-    Pointers points{};
 
+    //! A column dataset.
+    struct Column_t {
+        const char *name;   //!< Name of the dataset.
+        hid_t file_type;    //!< Type of the values in the file.
+        hid_t mem_type;     //!< Type of the buffered values.
+        hid_t dset;         //!< The dataset.
+    };
+
+    hid_t file;                     //!< Output file.
+    hid_t group;                    //!< Group of the columns.
+    std::vector<Column_t> columns;  //!< Column datasets.
+    hsize_t rows;                   //!< Number of rows written.
+
+    std::vector<uint16_t> dtype;    //!< Buffered detector types.
+    std::vector<int16_t> id;        //!< Buffered detector ID's.
+    std::vector<uint16_t> adcdata;  //!< Buffered raw energies.
+    std::vector<uint16_t> cfddata;  //!< Buffered CFD data.
+    std::vector<int64_t> timestamp; //!< Buffered timestamps.
+    std::vector<double> cfdcorr;    //!< Buffered CFD corrections.
+    std::vector<double> energy;     //!< Buffered calibrated energies.
+    std::vector<uint8_t> cfdfail;   //!< Buffered CFD fail flags.
+    std::vector<uint8_t> finishcode;//!< Buffered pile-up flags.
+
+    //! Extend the datasets and write the buffered entries.
+    void Flush();
 
 public:
 
-    HDF5_Writer() : noRows( 0 ), row_idx( 0 ), fd( 0 ){}
+    //! Number of rows in each chunk of the datasets, also the number of entries buffered.
+    static const size_t chunk_rows = 1 << 16;
 
-    HDF5_Writer(const char *fname, const int &nRows);
+    //! Create the file and the datasets.
+    /*!
+     * \throws std::runtime_error if the file or a dataset can't be created.
+     */
+    explicit HDF5_Writer(const char *fname  /*!< Output file name */);
 
+    //! Destructor. Writes the remaining entries and closes the file.
     ~HDF5_Writer();
 
-    void allocate(const char *fname, const int &nRows);
-
-    // Write an entry to file.
-    bool Write(const Parser::Entry_t &entry);
+    //! Write a batch of entries.
+    /*!
+     * \throws std::runtime_error if the datasets can't be written.
+     */
+    void Write(const Parser::Entry_t *entries,  /*!< Entries to write   */
+               const size_t &size               /*!< Number of entries  */);
 
+    //! Get the number of rows written so far.
+    inline size_t GetRows() const { return rows; }
 
 };
 
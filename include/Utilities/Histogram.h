@@ -0,0 +1,126 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/*!
+ * A light weight 2D histogram with fixed binning on the x-axis and
+ * one row per channel on the y-axis. The counts are stored as a flat
+ * array of 32-bit counters, row by row, such that all bins of a
+ * channel are contiguous in memory. Entries outside the range are ignored.
+ * The y-axis may also be given a range, such that each row covers a
+ * fixed width interval rather than a single channel.
+ */
+class Histogram2D {
+
+private:
+
+    int xbins;                      //!< Number of bins on the x-axis.
+    double xmin;                    //!< Lower edge of the first bin.
+    double xmax;                    //!< Upper edge of the last bin.
+    double inv_width;               //!< Inverse of the bin width.
+    int ybins;                      //!< Number of channels.
+    double ymin;                    //!< Lower edge of the first row.
+    double inv_ywidth;              //!< Inverse of the row width.
+    std::vector<uint32_t> counts;   //!< Counts, row major.
+
+public:
+
+    //! Constructor.
+    Histogram2D(int xbin, double xlow, double xhigh, int ybin)
+        : xbins( xbin ), xmin( xlow ), xmax( xhigh ), inv_width( xbin/(xhigh - xlow) )
+        , ybins( ybin ), ymin( 0 ), inv_ywidth( 1 ), counts( size_t(xbin)*size_t(ybin), 0 ){}
+
+    //! Constructor with a range on the y-axis.
+    Histogram2D(int xbin, double xlow, double xhigh, int ybin, double ylow, double yhigh)
+        : xbins( xbin ), xmin( xlow ), xmax( xhigh ), inv_width( xbin/(xhigh - xlow) )
+        , ybins( ybin ), ymin( ylow ), inv_ywidth( ybin/(yhigh - ylow) ), counts( size_t(xbin)*size_t(ybin), 0 ){}
+
+    //! Get the x-axis bin of a value, -1 if outside the range.
+    /*!
+     * The position is checked after scaling, as a value just below xmax may
+     * round up to xbins. NaN fails the check as well.
+     */
+    inline int FindXbin(const double &x) const
+    {
+        const double pos = (x - xmin)*inv_width;
+        return ( pos >= 0 && pos < xbins ) ? int(pos) : -1;
+    }
+
+    //! Fill an entry.
+    inline void Fill(const double &x, const int &y)
+    {
+        const int xbin = FindXbin(x);
+        if ( xbin < 0 || y < 0 || y >= ybins )
+            return;
+        ++counts[size_t(y)*xbins + xbin];
+    }
+
+    //! Fill an entry where the y-value is given on the y-axis range.
+    inline void FillXY(const double &x, const double &y)
+    {
+        const int xbin = FindXbin(x);
+        const double ypos = (y - ymin)*inv_ywidth;
+        if ( xbin < 0 || !( ypos >= 0 && ypos < ybins ) )
+            return;
+        ++counts[size_t(ypos)*xbins + xbin];
+    }
+
+    //! Fill an entry where the x-value is already a bin number.
+    inline void FillBin(const int &xbin, const int &y)
+    {
+        if ( xbin < 0 || xbin >= xbins || y < 0 || y >= ybins )
+            return;
+        ++counts[size_t(y)*xbins + xbin];
+    }
+
+    //! Add the content of an other histogram with the same binning.
+    void Add(const Histogram2D &other)
+    {
+        for ( size_t i = 0 ; i < counts.size() && i < other.counts.size() ; ++i )
+            counts[i] += other.counts[i];
+    }
+
+    //! Set all counts to zero.
+    void Reset(){ std::fill(counts.begin(), counts.end(), 0); }
+
+    //! Get all bins of a channel.
+    inline const uint32_t *GetRow(const int &y) const { return counts.data() + size_t(y)*xbins; }
+
+    //! Get the number of counts in a bin.
+    inline uint32_t GetBinContent(const int &xbin, const int &y) const { return counts[size_t(y)*xbins + xbin]; }
+
+    //! Get the center of a bin on the x-axis.
+    inline double GetBinCenter(const int &xbin) const { return xmin + (xbin + 0.5)/inv_width; }
+
+    //! Get the width of the bins on the x-axis.
+    inline double GetBinWidth() const { return 1./inv_width; }
+
+    //! Get number of bins on the x-axis.
+    inline int GetXbins() const { return xbins; }
+
+    //! Get lower edge of the x-axis.
+    inline double GetXmin() const { return xmin; }
+
+    //! Get upper edge of the x-axis.
+    inline double GetXmax() const { return xmax; }
+
+    //! Get number of channels.
+    inline int GetYbins() const { return ybins; }
+
+    //! Get lower edge of the y-axis.
+    inline double GetYmin() const { return ymin; }
+
+    //! Get upper edge of the y-axis.
+    inline double GetYmax() const { return ymin + ybins/inv_ywidth; }
+
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,60 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef REORDERSTAGE_H
+#define REORDERSTAGE_H
+
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include <Utilities/CLI_interface.h>
+
+/*!
+ * Restores the original order of chunks built in parallel.
+ * \brief Chunks are pushed in any order and forwarded to the output queue in order of their sequence number.
+ * \details Chunks arriving ahead of the next expected sequence number are kept
+ * until all earlier chunks have arrived. To bound the memory used, a thread pushing
+ * a chunk more than max_pending ahead of the next expected chunk is blocked until
+ * the earlier chunks have been forwarded. Every sequence number has to be pushed
+ * exactly once, including chunks without any events. If a chunk can't be built
+ * the stage has to be aborted, otherwise the other threads will wait for it forever.
+ */
+class ReorderStage {
+
+private:
+
+    Chunk_queue_t *output;                              //!< Queue to forward ordered chunks to.
+    const uint64_t max_pending;                         //!< Max. distance from next expected chunk.
+    uint64_t next;                                      //!< Sequence number of next chunk to forward.
+    std::map<uint64_t, Event::EventChunk> pending;      //!< Chunks waiting for an earlier chunk.
+    std::mutex mutex;                                   //!< Protects next and pending.
+    std::condition_variable forwarded;                  //!< Signaled when next is advanced.
+    bool aborted;                                       //!< Set when a chunk will never arrive.
+
+public:
+
+    //! Constructor.
+    ReorderStage(Chunk_queue_t *output_queue,   /*!< Queue to forward ordered chunks to.          */
+                 const size_t &max_chunks       /*!< Max. number of chunks kept out of order.     */);
+
+    //! Push a chunk. Blocks if the chunk is too far ahead of the next expected chunk.
+    /*!
+     * \return false if the stage has been aborted, the chunk is then dropped.
+     */
+    bool Push(Event::EventChunk &&chunk);
+
+    //! Abort the stage. Waiting threads are released and any further chunks are dropped.
+    void Abort();
+
+    //! Check if the stage has been aborted.
+    bool Aborted();
+
+    //! Get number of chunks waiting for an earlier chunk.
+    size_t Pending();
+
+};
+
+#endif // REORDERSTAGE_H
@@ -0,0 +1,89 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Event/Addback.h"
+
+#include <Parameters/experimentsetup.h>
+#include <Parameters/Calibration.h>
+
+#include <TH2.h>
+
+//! Copy a single hit.
+static inline void CopyHit(Event::EntryColumns &to, const Event::EntryColumns &from, const int &i)
+{
+    const int n = to.Next();
+    to.ID[n] = from.ID[i];
+    to.e_raw[n] = from.e_raw[i];
+    to.energy[n] = from.energy[i];
+    to.tfine[n] = from.tfine[i];
+    to.tcoarse[n] = from.tcoarse[i];
+    to.cfdvalid[n] = from.cfdvalid[i];
+}
+
+void Event::Addback(EntryColumns &clover, EntryColumns &scratch, TH2 *ab_t_clover)
+{
+    if ( clover.mult == 0 )
+        return;
+
+    // The hits are read from a copy while the merged hits are written back.
+    scratch = clover;
+    clover.mult = 0;
+
+    int hits[NUM_CLOVER_DETECTORS][MAX_ADDBACK_HITS];
+    int nhits[NUM_CLOVER_DETECTORS] = {0};
+    for ( int i = 0 ; i < scratch.mult ; ++i ){
+        const int n = scratch.ID[i]/NUM_CLOVER_CRYSTALS;
+        if ( n < NUM_CLOVER_DETECTORS && nhits[n] < MAX_ADDBACK_HITS )
+            hits[n][nhits[n]++] = i;
+        else
+            CopyHit(clover, scratch, i);
+    }
+
+    bool used[MAX_ADDBACK_HITS];
+    for ( int n = 0 ; n < NUM_CLOVER_DETECTORS ; ++n ){
+        const int size = nhits[n];
+        if ( size == 0 )
+            continue;
+
+        for ( int i = 0 ; i < size ; ++i )
+            used[i] = false;
+
+        for ( int left = size ; left > 0 ; ){
+
+            // Seed is the unused hit with the highest energy.
+            int seed = -1;
+            for ( int i = 0 ; i < size ; ++i ){
+                if ( !used[i] && ( seed < 0 || scratch.energy[hits[n][i]] > scratch.energy[hits[n][seed]] ) )
+                    seed = i;
+            }
+            // The time differences are only filled for the first seed, such that each hit is counted once.
+            const bool fill_time = ab_t_clover && left == size;
+            used[seed] = true;
+            --left;
+
+            const int s = hits[n][seed];
+            double energy = scratch.energy[s];
+            for ( int i = 0 ; i < size ; ++i ){
+                if ( used[i] )
+                    continue;
+                const int m = hits[n][i];
+                const double tdiff = double(scratch.tcoarse[m] - scratch.tcoarse[s]) + (scratch.tfine[m] - scratch.tfine[s]);
+                if ( fill_time )
+                    ab_t_clover->Fill(tdiff, n);
+                const bool in_gate = CheckTimeGateAddback(tdiff);
+                energy += in_gate ? scratch.energy[m] : 0.;
+                used[i] = in_gate;
+                left -= in_gate;
+            }
+
+            const int k = clover.Next();
+            clover.ID[k] = scratch.ID[s];
+            clover.e_raw[k] = 0;
+            clover.energy[k] = energy;
+            clover.tfine[k] = scratch.tfine[s];
+            clover.tcoarse[k] = scratch.tcoarse[s];
+            clover.cfdvalid[k] = scratch.cfdvalid[s];
+        }
+    }
+}
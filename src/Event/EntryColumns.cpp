@@ -0,0 +1,115 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Event/EntryColumns.h"
+
+#include <cstring>
+
+#include <TBranch.h>
+
+using namespace Event;
+
+EntryColumns::EntryColumns()
+    : mult( 0 )
+    , local{}
+    , capacity( inline_capacity )
+    , branches{}
+{
+    UseInline();
+}
+
+EntryColumns::EntryColumns(const EntryColumns &other)
+    : EntryColumns()
+{
+    *this = other;
+}
+
+EntryColumns &EntryColumns::operator=(const EntryColumns &other)
+{
+    if ( this == &other )
+        return *this;
+
+    if ( other.mult > capacity )
+        Grow(other.mult);
+    mult = other.mult;
+    memcpy(ID, other.ID, mult*sizeof(uint16_t));
+    memcpy(e_raw, other.e_raw, mult*sizeof(uint16_t));
+    memcpy(energy, other.energy, mult*sizeof(double));
+    memcpy(tfine, other.tfine, mult*sizeof(double));
+    memcpy(tcoarse, other.tcoarse, mult*sizeof(int64_t));
+    memcpy(cfdvalid, other.cfdvalid, mult*sizeof(bool));
+    return *this;
+}
+
+void EntryColumns::SetBranch(const Column &column, TBranch *branch)
+{
+    branches[column] = branch;
+}
+
+void EntryColumns::UseInline()
+{
+    ID = local.ID;
+    e_raw = local.e_raw;
+    energy = local.energy;
+    tfine = local.tfine;
+    tcoarse = local.tcoarse;
+    cfdvalid = local.cfdvalid;
+}
+
+void EntryColumns::Grow(const int &min_capacity)
+{
+    int new_capacity = 2*capacity;
+    while ( new_capacity < min_capacity )
+        new_capacity *= 2;
+
+    // The 8 byte columns are put first such that all columns are aligned.
+    const size_t bytes = size_t(new_capacity)*(3*sizeof(int64_t) + 2*sizeof(uint16_t) + sizeof(bool));
+    std::vector<int64_t> new_arena((bytes + sizeof(int64_t) - 1)/sizeof(int64_t));
+
+    auto *pos = reinterpret_cast<char *>(new_arena.data());
+    auto *new_energy = reinterpret_cast<double *>(pos);
+    pos += new_capacity*sizeof(double);
+    auto *new_tfine = reinterpret_cast<double *>(pos);
+    pos += new_capacity*sizeof(double);
+    auto *new_tcoarse = reinterpret_cast<int64_t *>(pos);
+    pos += new_capacity*sizeof(int64_t);
+    auto *new_ID = reinterpret_cast<uint16_t *>(pos);
+    pos += new_capacity*sizeof(uint16_t);
+    auto *new_e_raw = reinterpret_cast<uint16_t *>(pos);
+    pos += new_capacity*sizeof(uint16_t);
+    auto *new_cfdvalid = reinterpret_cast<bool *>(pos);
+
+    memcpy(new_ID, ID, mult*sizeof(uint16_t));
+    memcpy(new_e_raw, e_raw, mult*sizeof(uint16_t));
+    memcpy(new_energy, energy, mult*sizeof(double));
+    memcpy(new_tfine, tfine, mult*sizeof(double));
+    memcpy(new_tcoarse, tcoarse, mult*sizeof(int64_t));
+    memcpy(new_cfdvalid, cfdvalid, mult*sizeof(bool));
+
+    arena.swap(new_arena);
+    capacity = new_capacity;
+    ID = new_ID;
+    e_raw = new_e_raw;
+    energy = new_energy;
+    tfine = new_tfine;
+    tcoarse = new_tcoarse;
+    cfdvalid = new_cfdvalid;
+    Rebind();
+}
+
+void EntryColumns::Rebind()
+{
+    if ( branches[col_ID] )
+        branches[col_ID]->SetAddress(ID);
+    if ( branches[col_e_raw] )
+        branches[col_e_raw]->SetAddress(e_raw);
+    if ( branches[col_energy] )
+        branches[col_energy]->SetAddress(energy);
+    if ( branches[col_tfine] )
+        branches[col_tfine]->SetAddress(tfine);
+    if ( branches[col_tcoarse] )
+        branches[col_tcoarse]->SetAddress(tcoarse);
+    if ( branches[col_cfdvalid] )
+        branches[col_cfdvalid]->SetAddress(cfdvalid);
+}
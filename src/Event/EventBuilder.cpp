@@ -0,0 +1,67 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Event/EventBuilder.h"
+
+using namespace Event;
+
+inline double TimeDiff(const Parser::Entry_t &lhs, const Parser::Entry_t &rhs)
+{
+    return double(lhs.timestamp - rhs.timestamp) + (lhs.cfdcorr - rhs.cfdcorr);
+}
+
+size_t EventBuilder::BuildEvents(const Parser::Entry_t *entries, const size_t &size,
+                                 std::vector<EventRange> &events, const bool &flush) const
+{
+    size_t start = 0, stop, n = 0;
+    while ( n < size ){
+        if ( GetDetectorType(entries[n].address) != trigger ){
+            ++n;
+            continue;
+        }
+
+        while ( start < n && TimeDiff(entries[n], entries[start]) >= window )
+            ++start;
+
+        stop = n + 1;
+        while ( stop < size && TimeDiff(entries[stop], entries[n]) < window )
+            ++stop;
+
+        // The window may extend into entries we have not yet got.
+        if ( stop == size && !flush )
+            return start;
+
+        if ( !condition || condition->Accept(entries + start, entries + stop) )
+            events.push_back({uint32_t(start), uint32_t(stop)});
+        start = n = stop;
+    }
+
+    if ( flush || size == 0 )
+        return size;
+
+    // Keep the entries that may end up in the window of a later trigger.
+    while ( start < size && TimeDiff(entries[size - 1], entries[start]) >= window )
+        ++start;
+    return start;
+}
+
+void EventBuilder::BuildWindows(const Parser::Entry_t *entries, const size_t &size,
+                                std::vector<EventRange> &events, const WindowMode &mode) const
+{
+    if ( size == 0 )
+        return;
+
+    size_t start = 0;
+    for ( size_t n = 1 ; n < size ; ++n ){
+        const double tdiff = ( mode == fixed_window ) ? TimeDiff(entries[n], entries[start])
+                                                      : TimeDiff(entries[n], entries[n-1]);
+        if ( tdiff < window )
+            continue;
+        if ( !condition || condition->Accept(entries + start, entries + n) )
+            events.push_back({uint32_t(start), uint32_t(n)});
+        start = n;
+    }
+    if ( !condition || condition->Accept(entries + start, entries + size) )
+        events.push_back({uint32_t(start), uint32_t(size)});
+}
@@ -0,0 +1,66 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Event/StorageOptions.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <TTree.h>
+#include <TBranch.h>
+
+using namespace Event;
+
+void Event::CheckStorage(const StorageOptions &options)
+{
+    // ROOT only truncates the mantissa of a [0,0,nbits] leaf for 2 to 14 bits.
+    if ( options.energy_bits != 0 && options.energy_bits != 32 && (options.energy_bits < 2 || options.energy_bits > 14) )
+        throw std::invalid_argument("Energy bits has to be 0, 32 or between 2 and 14");
+    if ( options.tfine_bits != 0 && (options.tfine_bits < 2 || options.tfine_bits > 32) )
+        throw std::invalid_argument("Fine time bits has to be 0 or between 2 and 32");
+    if ( options.tfine_bits != 0 && options.tfine_range <= 0 )
+        throw std::invalid_argument("Fine time range has to be positive");
+}
+
+void Event::EnergyLeafType(char *type, const StorageOptions &options)
+{
+    if ( options.energy_bits == 0 )
+        sprintf(type, "D");
+    else if ( options.energy_bits == 32 )
+        sprintf(type, "d");
+    else
+        sprintf(type, "d[0,0,%d]", options.energy_bits);
+}
+
+void Event::TfineLeafType(char *type, const StorageOptions &options)
+{
+    if ( options.tfine_bits == 0 )
+        sprintf(type, "D");
+    else
+        sprintf(type, "d[%g,%g,%d]", -options.tfine_range, options.tfine_range, options.tfine_bits);
+}
+
+void Event::SetupEventTime(TTree *tree, int64_t *event_time)
+{
+    tree->Branch("eventTime", event_time, "eventTime/L");
+}
+
+void DeltaColumn::SetupBranch(TTree *tree, const char *name, const char *mult_name)
+{
+    char data_name[2048];
+    sprintf(data_name, "%s[%s]/I", name, mult_name);
+    branch = tree->Branch(name, delta.data(), data_name);
+}
+
+void DeltaColumn::Encode(const int64_t *tcoarse, const int &mult, const int64_t &reference)
+{
+    if ( size_t(mult) > delta.size() ){
+        delta.resize(2*mult);
+        if ( branch )
+            branch->SetAddress(delta.data());
+    }
+    // Events are much shorter than the ~2 s a 32 bit difference can hold.
+    for ( int i = 0 ; i < mult ; ++i )
+        delta[i] = int32_t(tcoarse[i] - reference);
+}
@@ -0,0 +1,216 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Event/TriggerCondition.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <cstring>
+
+namespace Event {
+
+    //! Recursive descent parser producing the terms of a condition.
+    /*!
+     * expr   := and ( '|' and )*
+     * and    := factor ( '&' factor )*
+     * factor := '(' expr ')' | name [ ( '>=' | '>' ) number ]
+     */
+    class ConditionParser {
+
+    public:
+
+        typedef std::vector<TriggerCondition::Term> Terms_t;
+
+        explicit ConditionParser(const std::string &expr) : str( expr ), pos( 0 ){}
+
+        Terms_t Parse()
+        {
+            Terms_t terms = Expr();
+            SkipSpace();
+            if ( pos != str.size() )
+                Error("unexpected character");
+            return terms;
+        }
+
+    private:
+
+        const std::string &str;
+        size_t pos;
+
+        void Error(const char *what) const
+        {
+            throw std::invalid_argument("Invalid trigger condition '" + str + "': " + what +
+                                        " at position " + std::to_string(pos));
+        }
+
+        void SkipSpace()
+        {
+            while ( pos < str.size() && isspace(str[pos]) )
+                ++pos;
+        }
+
+        bool Accept(const char &c)
+        {
+            SkipSpace();
+            if ( pos < str.size() && str[pos] == c ){
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+
+        Terms_t Expr()
+        {
+            Terms_t terms = And();
+            while ( Accept('|') ){
+                Terms_t rhs = And();
+                terms.insert(terms.end(), rhs.begin(), rhs.end());
+            }
+            return terms;
+        }
+
+        Terms_t And()
+        {
+            Terms_t terms = Factor();
+            while ( Accept('&') ){
+                Terms_t rhs = Factor();
+                Terms_t product;
+                product.reserve(terms.size()*rhs.size());
+                for ( auto &a : terms ){
+                    for ( auto &b : rhs ){
+                        TriggerCondition::Term term = a;
+                        term.mask |= b.mask;
+                        term.mult_mask |= b.mult_mask;
+                        for ( int i = 0 ; i < TriggerCondition::num_types ; ++i )
+                            term.mult[i] = std::max(a.mult[i], b.mult[i]);
+                        product.push_back(term);
+                    }
+                }
+                terms.swap(product);
+            }
+            return terms;
+        }
+
+        Terms_t Factor()
+        {
+            if ( Accept('(') ){
+                Terms_t terms = Expr();
+                if ( !Accept(')') )
+                    Error("expected ')'");
+                return terms;
+            }
+
+            TriggerCondition::Term term = {0, 0, {0}};
+            DetectorType type = Name();
+            int mult = 1;
+            if ( Accept('>') ){
+                bool equal = Accept('=');
+                mult = Number() + ( equal ? 0 : 1 );
+            }
+            term.mask = 1u << type;
+            term.mult[type] = mult;
+            if ( mult > 1 )
+                term.mult_mask = 1u << type;
+            return Terms_t(1, term);
+        }
+
+        DetectorType Name()
+        {
+            static const struct { const char *name; DetectorType type; } names[] = {
+                {"labr_3x8", labr_3x8},
+                {"labr_2x2_ss", labr_2x2_ss},
+                {"labr_2x2_fs", labr_2x2_fs},
+                {"clover", clover},
+                {"de_ring", de_ring},
+                {"de_sect", de_sect},
+                {"eDet", eDet},
+                {"rfchan", rfchan}
+            };
+
+            SkipSpace();
+            size_t start = pos;
+            while ( pos < str.size() && ( isalnum(str[pos]) || str[pos] == '_' ) )
+                ++pos;
+            if ( start == pos )
+                Error("expected detector type");
+
+            std::string name = str.substr(start, pos - start);
+            for ( auto &n : names ){
+                if ( strcasecmp(name.c_str(), n.name) == 0 )
+                    return n.type;
+            }
+            pos = start;
+            Error(("unknown detector type '" + name + "'").c_str());
+            return invalid;
+        }
+
+        int Number()
+        {
+            SkipSpace();
+            size_t start = pos;
+            int number = 0;
+            while ( pos < str.size() && isdigit(str[pos]) && number < 0x10000 )
+                number = 10*number + ( str[pos++] - '0' );
+            if ( start == pos )
+                Error("expected multiplicity");
+            return number;
+        }
+
+    };
+
+}
+
+using namespace Event;
+
+TriggerCondition::TriggerCondition(const std::string &expr)
+    : terms( ConditionParser(expr).Parse() )
+    , expression( expr )
+{
+    // Terms requiring a superset of an other term will never change the outcome.
+    std::vector<Term> reduced;
+    for ( size_t i = 0 ; i < terms.size() ; ++i ){
+        bool redundant = false;
+        for ( size_t j = 0 ; j < terms.size() && !redundant ; ++j ){
+            if ( i == j || ( terms[j].mask & ~terms[i].mask ) != 0 )
+                continue;
+            bool weaker = true;
+            for ( int k = 0 ; k < num_types && weaker ; ++k )
+                weaker = terms[j].mult[k] <= terms[i].mult[k];
+            // Of identical terms only the first is kept.
+            bool identical = terms[j].mask == terms[i].mask &&
+                    std::equal(terms[j].mult, terms[j].mult + num_types, terms[i].mult);
+            redundant = weaker && ( !identical || j < i );
+        }
+        if ( !redundant )
+            reduced.push_back(terms[i]);
+    }
+    terms.swap(reduced);
+}
+
+bool TriggerCondition::Accept(const Parser::Entry_t *begin, const Parser::Entry_t *end) const
+{
+    uint32_t mask = 0;
+    int count[num_types] = {0};
+    for ( const Parser::Entry_t *entry = begin ; entry != end ; ++entry ){
+        DetectorType type = GetDetectorType(entry->address);
+        mask |= 1u << type;
+        ++count[type];
+    }
+
+    for ( auto &term : terms ){
+        if ( ( mask & term.mask ) != term.mask )
+            continue;
+        if ( term.mult_mask == 0 )
+            return true;
+        bool accept = true;
+        for ( int i = 0 ; i < num_types && accept ; ++i ){
+            if ( term.mult_mask & ( 1u << i ) )
+                accept = count[i] >= term.mult[i];
+        }
+        if ( accept )
+            return true;
+    }
+    return false;
+}
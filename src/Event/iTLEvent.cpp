@@ -9,64 +9,76 @@
 #include <TTree.h>
 
 #include "Event/iTLEvent.h"
+#include "Event/Addback.h"
 
 using namespace Event;
 
 
 bool iTLData::Add(const Parser::Entry_t &word)
 {
-    if ( mult < MAX_MULT ){
-        ID[mult] = (GetDetector(word.address).type != clover) ?
-                   GetDetector(word.address).detectorNum : GetDetector(word.address).detectorNum*NUM_CLOVER_CRYSTALS + GetDetector(word.address).telNum;
-        e_raw[mult] = word.adcdata;
-        energy[mult] = word.energy;
-        tfine[mult] = word.cfdcorr;
-        tcoarse[mult] = word.timestamp;
-        cfdvalid[mult++] = !word.cfdfail;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.ID[i] = (GetDetector(word.address).type != clover) ?
+               GetDetector(word.address).detectorNum : GetDetector(word.address).detectorNum*NUM_CLOVER_CRYSTALS + GetDetector(word.address).telNum;
+    data.e_raw[i] = word.adcdata;
+    data.energy[i] = word.energy;
+    data.tfine[i] = word.cfdcorr;
+    data.tcoarse[i] = word.timestamp;
+    data.cfdvalid[i] = !word.cfdfail;
+    return true;
 }
 
 bool iTLData::Add(const iTLEntry &word)
 {
-    if ( mult < MAX_MULT ){
-        ID[mult] = word.ID;
-        e_raw[mult] = word.e_raw;
-        energy[mult] = word.energy;
-        tfine[mult] = word.tfine;
-        tcoarse[mult] = word.tcoarse;
-        cfdvalid[mult++] = word.cfdvalid;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.ID[i] = word.ID;
+    data.e_raw[i] = word.e_raw;
+    data.energy[i] = word.energy;
+    data.tfine[i] = word.tfine;
+    data.tcoarse[i] = word.tcoarse;
+    data.cfdvalid[i] = word.cfdvalid;
+    return true;
 }
 
 
-void iTLData::SetupBranch(TTree *tree, const char *baseName)
+void iTLData::SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage)
 {
-    char mult_name[2048], branch_name[2048], data_name[2048];
+    char mult_name[2048], branch_name[2048], data_name[2048], leaf_type[64];
     sprintf(mult_name, "%sMult", baseName);
     sprintf(data_name, "%s/I", mult_name);
-    bMult = tree->Branch(mult_name, &mult, data_name);
+    bMult = tree->Branch(mult_name, &data.mult, data_name);
     sprintf(branch_name, "%sID", baseName);
     sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
-    bID = tree->Branch(branch_name, &ID, data_name);
+    bID = tree->Branch(branch_name, data.ID, data_name);
     sprintf(branch_name, "%s_e_raw", baseName);
     sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
-    bRaw = tree->Branch(branch_name, &e_raw, data_name);
+    bRaw = tree->Branch(branch_name, data.e_raw, data_name);
     sprintf(branch_name, "%sEnergy", baseName);
-    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
-    bEnergy = tree->Branch(branch_name, &energy, data_name);
+    EnergyLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    bEnergy = tree->Branch(branch_name, data.energy, data_name);
     sprintf(branch_name, "%sTfine", baseName);
-    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
-    bTfine = tree->Branch(branch_name, &tfine, data_name);
-    sprintf(branch_name, "%sTcoarse", baseName);
-    sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
-    bTcoarse = tree->Branch(branch_name, &tcoarse, data_name);
+    TfineLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    bTfine = tree->Branch(branch_name, data.tfine, data_name);
+    if ( storage.tcoarse_delta ){
+        sprintf(branch_name, "%sTdelta", baseName);
+        tdelta.SetupBranch(tree, branch_name, mult_name);
+    } else {
+        sprintf(branch_name, "%sTcoarse", baseName);
+        sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
+        bTcoarse = tree->Branch(branch_name, data.tcoarse, data_name);
+    }
     sprintf(branch_name, "%sCFDvalid", baseName);
     sprintf(data_name, "%s[%s]/O", branch_name, mult_name);
-    bCfdvalid = tree->Branch(branch_name, &cfdvalid, data_name);
+    bCfdvalid = tree->Branch(branch_name, data.cfdvalid, data_name);
+
+    // The columns move when the multiplicity exceeds the capacity.
+    data.SetBranch(EntryColumns::col_ID, bID);
+    data.SetBranch(EntryColumns::col_e_raw, bRaw);
+    data.SetBranch(EntryColumns::col_energy, bEnergy);
+    data.SetBranch(EntryColumns::col_tfine, bTfine);
+    data.SetBranch(EntryColumns::col_tcoarse, bTcoarse);
+    data.SetBranch(EntryColumns::col_cfdvalid, bCfdvalid);
 }
 
 
@@ -75,38 +87,22 @@ void iTLData::Copy(const Event::EventData *other)
     if ( other == nullptr )
         return;
 
-    auto *iTLother = reinterpret_cast<const iTLData *>(other);
-    mult = iTLother->mult;
-    for ( int i = 0 ; i < iTLother->mult ; ++i ){
-        ID[i] = iTLother->ID[i];
-        e_raw[i] = iTLother->e_raw[i];
-        energy[i] = iTLother->energy[i];
-        tfine[i] = iTLother->tfine[i];
-        tcoarse[i] = iTLother->tcoarse[i];
-        cfdvalid[i] = iTLother->cfdvalid[i];
-    }
+    data = reinterpret_cast<const iTLData *>(other)->data;
 }
 
 std::vector<iTLEntry> iTLData::GetEntries() const
 {
-    std::vector<iTLEntry> data(mult);
-    for ( int i = 0 ; i < mult ; ++i ){
-        data.push_back({ID[i], e_raw[i], energy[i], tfine[i], tcoarse[i], cfdvalid[i]});
+    std::vector<iTLEntry> entries;
+    entries.reserve(data.mult);
+    for ( int i = 0 ; i < data.mult ; ++i ){
+        entries.push_back({data.ID[i], data.e_raw[i], data.energy[i], data.tfine[i], data.tcoarse[i], data.cfdvalid[i]});
     }
-    return data;
+    return entries;
 }
 
 
 iTLEvent::iTLEvent(TTree *tree)
 {
-    Register(&ringData, "ring");
-    Register(&sectData, "sector");
-    Register(&backData, "back");
-    Register(&labrLData, "labrL");
-    Register(&labrSData, "labrS");
-    Register(&labrFData, "labrF");
-    Register(&cloverData, "clover");
-    Register(&rfData, "rf");
     if ( tree != nullptr )
         SetupTree(tree);
 }
@@ -118,61 +114,37 @@ iTLEvent::iTLEvent(const std::vector<Parser::Entry_t> &data)
 
         switch ( GetDetectorType(entry.address) ){
 
-            case de_ring : {
-                if ( !ringData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many ring words." << std::endl;
-                }
+            case de_ring :
+                ringData.Add(entry);
                 break;
-            }
 
-            case de_sect : {
-                if ( !sectData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many sect words." << std::endl;
-                }
+            case de_sect :
+                sectData.Add(entry);
                 break;
-            }
 
-            case eDet : {
-                if ( !backData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many back words." << std::endl;
-                }
+            case eDet :
+                backData.Add(entry);
                 break;
-            }
 
-            case labr_3x8 : {
-                if ( !labrLData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrL words." << std::endl;
-                }
+            case labr_3x8 :
+                labrLData.Add(entry);
                 break;
-            }
 
-            case labr_2x2_ss : {
-                if ( !labrSData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrS words." << std::endl;
-                }
+            case labr_2x2_ss :
+                labrSData.Add(entry);
                 break;
-            }
 
-            case labr_2x2_fs : {
-                if ( !labrFData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrF words." << std::endl;
-                }
+            case labr_2x2_fs :
+                labrFData.Add(entry);
                 break;
-            }
 
-            case clover : {
-                if ( !cloverData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many clover words." << std::endl;
-                }
+            case clover :
+                cloverData.Add(entry);
                 break;
-            }
 
-            case rfchan : {
-                if ( !rfData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many rf words." << std::endl;
-                }
+            case rfchan :
+                rfData.Add(entry);
                 break;
-            }
             default :
                 break;
         }
@@ -181,32 +153,5 @@ iTLEvent::iTLEvent(const std::vector<Parser::Entry_t> &data)
 
 void iTLEvent::Addback(TH2 *ab_t_clover)
 {
-    // We set up a vector for each clover.
-    std::vector<iTLEntry> cevent[NUM_CLOVER_DETECTORS];
-    for ( auto &entry : cloverData.GetEntries() ){
-        cevent[entry.ID/4].push_back(entry);
-    }
-    cloverData.Reset();
-    std::vector<iTLEntry> v, v_new;
-    double e, tdiff;
-    for (size_t n = 0 ; n < NUM_CLOVER_DETECTORS ; ++n){
-        v = cevent[n];
-        std::sort(v.begin(), v.end(), [](const iTLEntry &lhs, const iTLEntry &rhs){ return lhs.energy > rhs.energy; });
-        while ( !v.empty() ){
-            v_new.clear();
-            e = v[0].energy;
-            for (size_t m = 1 ; m < v.size() ; ++m){
-                tdiff = double(v[m].tcoarse - v[0].tcoarse);
-                tdiff += (v[m].tfine - v[0].tfine);
-                ab_t_clover->Fill(tdiff, n);
-                if ( CheckTimeGateAddback(tdiff) ){
-                    e += v[m].energy;
-                } else {
-                    v_new.push_back(v[m]);
-                }
-            }
-            cloverData.Add(iTLEntry({v[0].ID, 0, e, v[0].tfine, v[0].tcoarse, v[0].cfdvalid}));
-            v = v_new;
-        }
-    }
-}
\ No newline at end of file
+    Event::Addback(cloverData.data, addbackScratch, ab_t_clover);
+}
@@ -7,84 +7,85 @@
 //
 
 #include "Event/iThembaEvent.h"
+#include "Event/Addback.h"
 #include "Parameters/experimentsetup.h"
 #include "Parameters/Calibration.h"
 
 #include <vector>
 #include <string>
 #include <iostream>
+#include <algorithm>
 
 #include <TTree.h>
 #include <TH2.h>
 
 using namespace Event;
 
-/*void iThembaData::SetBranchAddress(Event::EventData *other)
+void iThembaData::SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage)
 {
-    auto *evt = reinterpret_cast<iThembaData *>(other);
-    b_mult->SetAddress(&evt->mult);
-    b_ID->SetAddress(&evt->ID);
-    b_e_raw->SetAddress(&evt->e_raw);
-    b_energy->SetAddress(&evt->energy);
-    b_tfine->SetAddress(&evt->tfine);
-    b_tcoarse->SetAddress(&evt->tcoarse);
-    b_cfdvalid->SetAddress(&evt->cfdvalid);
-}*/
-
-void iThembaData::SetupBranch(TTree *tree, const char *baseName)
-{
-    char mult_name[2048], branch_name[2048], data_name[2048];
+    char mult_name[2048], branch_name[2048], data_name[2048], leaf_type[64];
     sprintf(mult_name, "%sMult", baseName);
     sprintf(data_name, "%s/I", mult_name);
-    b_mult = tree->Branch(mult_name, &mult, data_name);
+    b_mult = tree->Branch(mult_name, &data.mult, data_name);
     sprintf(branch_name, "%sID", baseName);
     sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
-    b_ID = tree->Branch(branch_name, &ID, data_name);
+    b_ID = tree->Branch(branch_name, data.ID, data_name);
     sprintf(branch_name, "%s_e_raw", baseName);
     sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
-    b_e_raw = tree->Branch(branch_name, &e_raw, data_name);
+    b_e_raw = tree->Branch(branch_name, data.e_raw, data_name);
     sprintf(branch_name, "%sEnergy", baseName);
-    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
-    b_energy = tree->Branch(branch_name, &energy, data_name);
+    EnergyLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_energy = tree->Branch(branch_name, data.energy, data_name);
     sprintf(branch_name, "%sTfine", baseName);
-    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
-    b_tfine = tree->Branch(branch_name, &tfine, data_name);
-    sprintf(branch_name, "%sTcoarse", baseName);
-    sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
-    b_tcoarse = tree->Branch(branch_name, &tcoarse, data_name);
+    TfineLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_tfine = tree->Branch(branch_name, data.tfine, data_name);
+    if ( storage.tcoarse_delta ){
+        sprintf(branch_name, "%sTdelta", baseName);
+        tdelta.SetupBranch(tree, branch_name, mult_name);
+    } else {
+        sprintf(branch_name, "%sTcoarse", baseName);
+        sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
+        b_tcoarse = tree->Branch(branch_name, data.tcoarse, data_name);
+    }
     sprintf(branch_name, "%sCFDvalid", baseName);
     sprintf(data_name, "%s[%s]/O", branch_name, mult_name);
-    b_cfdvalid = tree->Branch(branch_name, &cfdvalid, data_name);
+    b_cfdvalid = tree->Branch(branch_name, data.cfdvalid, data_name);
+
+    // The columns move when the multiplicity exceeds the capacity.
+    data.SetBranch(EntryColumns::col_ID, b_ID);
+    data.SetBranch(EntryColumns::col_e_raw, b_e_raw);
+    data.SetBranch(EntryColumns::col_energy, b_energy);
+    data.SetBranch(EntryColumns::col_tfine, b_tfine);
+    data.SetBranch(EntryColumns::col_tcoarse, b_tcoarse);
+    data.SetBranch(EntryColumns::col_cfdvalid, b_cfdvalid);
 }
 
 
 bool iThembaData::Add(const Parser::Entry_t &word)
 {
-    if ( mult < MAX_NUM ){
-        ID[mult] = (GetDetector(word.address).type != clover) ?
-                   GetDetector(word.address).detectorNum : GetDetector(word.address).detectorNum*NUM_CLOVER_CRYSTALS + GetDetector(word.address).telNum;
-        e_raw[mult] = word.adcdata;
-        energy[mult] = word.energy;
-        tfine[mult] = word.cfdcorr;
-        tcoarse[mult] = word.timestamp;
-        cfdvalid[mult++] = !word.cfdfail;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.ID[i] = (GetDetector(word.address).type != clover) ?
+               GetDetector(word.address).detectorNum : GetDetector(word.address).detectorNum*NUM_CLOVER_CRYSTALS + GetDetector(word.address).telNum;
+    data.e_raw[i] = word.adcdata;
+    data.energy[i] = word.energy;
+    data.tfine[i] = word.cfdcorr;
+    data.tcoarse[i] = word.timestamp;
+    data.cfdvalid[i] = !word.cfdfail;
+    return true;
 }
 
 bool iThembaData::Add(const iThembaEntry &entry)
 {
-    if ( mult < MAX_NUM ){
-        ID[mult] = entry.ID;
-        e_raw[mult] = entry.e_raw;
-        energy[mult] = entry.energy;
-        tfine[mult] = entry.tfine;
-        tcoarse[mult] = entry.tcoarse;
-        cfdvalid[mult++] = entry.cfdvalid;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.ID[i] = entry.ID;
+    data.e_raw[i] = entry.e_raw;
+    data.energy[i] = entry.energy;
+    data.tfine[i] = entry.tfine;
+    data.tcoarse[i] = entry.tcoarse;
+    data.cfdvalid[i] = entry.cfdvalid;
+    return true;
 }
 
 
@@ -93,64 +94,53 @@ void iThembaData::Copy(const Event::EventData *other)
     if ( other == nullptr )
         return;
 
-    auto *iTLother = reinterpret_cast<const iThembaData *>(other);
-    mult = iTLother->mult;
-    for ( int i = 0 ; i < iTLother->mult ; ++i ){
-        ID[i] = iTLother->ID[i];
-        e_raw[i] = iTLother->e_raw[i];
-        energy[i] = iTLother->energy[i];
-        tfine[i] = iTLother->tfine[i];
-        tcoarse[i] = iTLother->tcoarse[i];
-        cfdvalid[i] = iTLother->cfdvalid[i];
-    }
+    data = reinterpret_cast<const iThembaData *>(other)->data;
 }
 
-/*void iThembaTimeData::SetBranchAddress(Event::EventData *other)
+void iThembaTimeData::SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage)
 {
-    auto *evt = reinterpret_cast<iThembaTimeData *>(other);
-    b_mult->SetAddress(&evt->mult);
-    b_tfine->SetAddress(&evt->tfine);
-    b_tcoarse->SetAddress(&evt->tcoarse);
-    b_cfdvalid->SetAddress(&evt->cfdvalid);
-}*/
-
-void iThembaTimeData::SetupBranch(TTree *tree, const char *baseName)
-{
-    char mult_name[2048], branch_name[2048], data_name[2048];
+    char mult_name[2048], branch_name[2048], data_name[2048], leaf_type[64];
     sprintf(mult_name, "%sMult", baseName);
     sprintf(data_name, "%s/I", mult_name);
-    b_mult = tree->Branch(mult_name, &mult, data_name);
+    b_mult = tree->Branch(mult_name, &data.mult, data_name);
     sprintf(branch_name, "%sTfine", baseName);
-    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
-    b_tfine = tree->Branch(branch_name, &tfine, data_name);
-    sprintf(branch_name, "%sTcoarse", baseName);
-    sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
-    b_tcoarse = tree->Branch(branch_name, &tcoarse, data_name);
+    TfineLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_tfine = tree->Branch(branch_name, data.tfine, data_name);
+    if ( storage.tcoarse_delta ){
+        sprintf(branch_name, "%sTdelta", baseName);
+        tdelta.SetupBranch(tree, branch_name, mult_name);
+    } else {
+        sprintf(branch_name, "%sTcoarse", baseName);
+        sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
+        b_tcoarse = tree->Branch(branch_name, data.tcoarse, data_name);
+    }
     sprintf(branch_name, "%ssCFDvalid", baseName);
     sprintf(data_name, "%s[%s]/O", branch_name, mult_name);
-    b_cfdvalid = tree->Branch(branch_name, &cfdvalid, data_name);
+    b_cfdvalid = tree->Branch(branch_name, data.cfdvalid, data_name);
+
+    // The columns move when the multiplicity exceeds the capacity.
+    data.SetBranch(EntryColumns::col_tfine, b_tfine);
+    data.SetBranch(EntryColumns::col_tcoarse, b_tcoarse);
+    data.SetBranch(EntryColumns::col_cfdvalid, b_cfdvalid);
 }
 
 bool iThembaTimeData::Add(const Parser::Entry_t &word)
 {
-    if ( mult < MAX_NUM ){
-        tfine[mult] = word.cfdcorr;
-        tcoarse[mult] = word.timestamp;
-        cfdvalid[mult++] = !word.cfdfail;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.tfine[i] = word.cfdcorr;
+    data.tcoarse[i] = word.timestamp;
+    data.cfdvalid[i] = !word.cfdfail;
+    return true;
 }
 
 bool iThembaTimeData::Add(const iThembaEntry &entry)
 {
-    if ( mult < MAX_NUM ){
-        tfine[mult] = entry.tfine;
-        tcoarse[mult] = entry.tcoarse;
-        cfdvalid[mult++] = entry.cfdvalid;
-        return true;
-    }
-    return false;
+    const int i = data.Next();
+    data.tfine[i] = entry.tfine;
+    data.tcoarse[i] = entry.tcoarse;
+    data.cfdvalid[i] = entry.cfdvalid;
+    return true;
 }
 
 void iThembaTimeData::Copy(const Event::EventData *other)
@@ -158,126 +148,297 @@ void iThembaTimeData::Copy(const Event::EventData *other)
     if ( other == nullptr )
         return;
 
-    auto *iTLother = reinterpret_cast<const iThembaTimeData *>(other);
-    mult = iTLother->mult;
-    for ( int i = 0 ; i < iTLother->mult ; ++i ){
-        tfine[i] = iTLother->tfine[i];
-        tcoarse[i] = iTLother->tcoarse[i];
-        cfdvalid[i] = iTLother->cfdvalid[i];
+    data = reinterpret_cast<const iThembaTimeData *>(other)->data;
+}
+
+
+iThembaParticleData::iThembaParticleData()
+    : mult( 0 ), capacity( 0 )
+    , b_mult( nullptr ), b_telescope( nullptr ), b_ring( nullptr ), b_sect( nullptr ), b_back( nullptr )
+    , b_dE( nullptr ), b_E( nullptr ), b_theta( nullptr ), b_tfine( nullptr ), b_tcoarse( nullptr )
+{
+    Grow(4);
+}
+
+iThembaParticleData::iThembaParticleData(const iThembaParticleData &other)
+    : iThembaParticleData()
+{
+    Copy(&other);
+}
+
+void iThembaParticleData::Grow(const int &min_capacity)
+{
+    capacity = ( capacity > 0 ) ? capacity : 1;
+    while ( capacity < min_capacity )
+        capacity *= 2;
+    telescope.resize(capacity);
+    ring.resize(capacity);
+    sect.resize(capacity);
+    back.resize(capacity);
+    dE.resize(capacity);
+    E.resize(capacity);
+    theta.resize(capacity);
+    tfine.resize(capacity);
+    tcoarse.resize(capacity);
+
+    // The columns have moved.
+    if ( b_telescope ){
+        b_telescope->SetAddress(telescope.data());
+        b_ring->SetAddress(ring.data());
+        b_sect->SetAddress(sect.data());
+        b_back->SetAddress(back.data());
+        b_dE->SetAddress(dE.data());
+        b_E->SetAddress(E.data());
+        b_theta->SetAddress(theta.data());
+        b_tfine->SetAddress(tfine.data());
+        if ( b_tcoarse )
+            b_tcoarse->SetAddress(tcoarse.data());
     }
 }
 
+void iThembaParticleData::Add(const iThembaParticle &particle)
+{
+    if ( mult == capacity )
+        Grow(mult + 1);
+    telescope[mult] = particle.telescope;
+    ring[mult] = particle.ring;
+    sect[mult] = particle.sect;
+    back[mult] = particle.back;
+    dE[mult] = particle.dE;
+    E[mult] = particle.E;
+    theta[mult] = particle.theta;
+    tfine[mult] = particle.tfine;
+    tcoarse[mult++] = particle.tcoarse;
+}
+
+void iThembaParticleData::SetupBranch(TTree *tree, const char *baseName, const StorageOptions &storage)
+{
+    char mult_name[2048], branch_name[2048], data_name[2048], leaf_type[64];
+    sprintf(mult_name, "%sMult", baseName);
+    sprintf(data_name, "%s/I", mult_name);
+    b_mult = tree->Branch(mult_name, &mult, data_name);
+    sprintf(branch_name, "%sTelescope", baseName);
+    sprintf(data_name, "%s[%s]/S", branch_name, mult_name);
+    b_telescope = tree->Branch(branch_name, telescope.data(), data_name);
+    sprintf(branch_name, "%sRing", baseName);
+    sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
+    b_ring = tree->Branch(branch_name, ring.data(), data_name);
+    sprintf(branch_name, "%sSect", baseName);
+    sprintf(data_name, "%s[%s]/S", branch_name, mult_name);
+    b_sect = tree->Branch(branch_name, sect.data(), data_name);
+    sprintf(branch_name, "%sBack", baseName);
+    sprintf(data_name, "%s[%s]/s", branch_name, mult_name);
+    b_back = tree->Branch(branch_name, back.data(), data_name);
+    EnergyLeafType(leaf_type, storage);
+    sprintf(branch_name, "%s_dE", baseName);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_dE = tree->Branch(branch_name, dE.data(), data_name);
+    sprintf(branch_name, "%s_E", baseName);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_E = tree->Branch(branch_name, E.data(), data_name);
+    sprintf(branch_name, "%sTheta", baseName);
+    sprintf(data_name, "%s[%s]/D", branch_name, mult_name);
+    b_theta = tree->Branch(branch_name, theta.data(), data_name);
+    sprintf(branch_name, "%sTfine", baseName);
+    TfineLeafType(leaf_type, storage);
+    sprintf(data_name, "%s[%s]/%s", branch_name, mult_name, leaf_type);
+    b_tfine = tree->Branch(branch_name, tfine.data(), data_name);
+    if ( storage.tcoarse_delta ){
+        sprintf(branch_name, "%sTdelta", baseName);
+        tdelta.SetupBranch(tree, branch_name, mult_name);
+    } else {
+        sprintf(branch_name, "%sTcoarse", baseName);
+        sprintf(data_name, "%s[%s]/L", branch_name, mult_name);
+        b_tcoarse = tree->Branch(branch_name, tcoarse.data(), data_name);
+    }
+}
+
+void iThembaParticleData::Copy(const Event::EventData *other)
+{
+    if ( other == nullptr || other == this )
+        return;
+
+    auto *pother = reinterpret_cast<const iThembaParticleData *>(other);
+    if ( pother->mult > capacity )
+        Grow(pother->mult);
+    mult = pother->mult;
+    std::copy(pother->telescope.begin(), pother->telescope.begin() + mult, telescope.begin());
+    std::copy(pother->ring.begin(), pother->ring.begin() + mult, ring.begin());
+    std::copy(pother->sect.begin(), pother->sect.begin() + mult, sect.begin());
+    std::copy(pother->back.begin(), pother->back.begin() + mult, back.begin());
+    std::copy(pother->dE.begin(), pother->dE.begin() + mult, dE.begin());
+    std::copy(pother->E.begin(), pother->E.begin() + mult, E.begin());
+    std::copy(pother->theta.begin(), pother->theta.begin() + mult, theta.begin());
+    std::copy(pother->tfine.begin(), pother->tfine.begin() + mult, tfine.begin());
+    std::copy(pother->tcoarse.begin(), pother->tcoarse.begin() + mult, tcoarse.begin());
+}
+
+std::vector<iThembaParticle> iThembaParticleData::GetEntries() const
+{
+    std::vector<iThembaParticle> particles;
+    particles.reserve(mult);
+    for ( int i = 0 ; i < mult ; ++i ){
+        particles.push_back({telescope[i], ring[i], sect[i], back[i], dE[i], E[i], theta[i], tfine[i], tcoarse[i]});
+    }
+    return particles;
+}
+
 
 iThembaEvent::iThembaEvent(TTree *tree)
 {
-    Register(&ringData, "ring");
-    Register(&sectData, "sector");
-    Register(&backData, "back");
-    Register(&labrLData, "labrL");
-    Register(&labrSData, "labrS");
-    Register(&labrFData, "labrF");
-    Register(&cloverData, "clover");
-    Register(&rfData, "rf");
     if ( tree )
         SetupTree(tree);
 }
 
 iThembaEvent::iThembaEvent(const std::vector<Parser::Entry_t> &data)
+        : iThembaEvent(data.data(), data.data() + data.size())
+{
+}
+
+iThembaEvent::iThembaEvent(const Parser::Entry_t *begin, const Parser::Entry_t *end)
         : iThembaEvent()
 {
-    for ( auto &entry : data ){
+    Fill(begin, end);
+}
+
+void iThembaEvent::Fill(const Parser::Entry_t *begin, const Parser::Entry_t *end)
+{
+    Reset();
+    for ( const Parser::Entry_t *pos = begin ; pos != end ; ++pos ){
+        const Parser::Entry_t &entry = *pos;
 
         switch ( GetDetectorType(entry.address) ){
 
-            case de_ring : {
-                if ( !ringData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many ring words." << std::endl;
-                }
+            case de_ring :
+                ringData.Add(entry);
                 break;
-            }
 
-            case de_sect : {
-                if ( !sectData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many sect words." << std::endl;
-                }
+            case de_sect :
+                sectData.Add(entry);
                 break;
-            }
 
-            case eDet : {
-                if ( !backData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many back words." << std::endl;
-                }
+            case eDet :
+                backData.Add(entry);
                 break;
-            }
 
-            case labr_3x8 : {
-                if ( !labrLData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrL words." << std::endl;
-                }
+            case labr_3x8 :
+                labrLData.Add(entry);
                 break;
-            }
 
-            case labr_2x2_ss : {
-                if ( !labrSData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrS words." << std::endl;
-                }
+            case labr_2x2_ss :
+                labrSData.Add(entry);
                 break;
-            }
 
-            case labr_2x2_fs : {
-                if ( !labrFData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many labrF words." << std::endl;
-                }
+            case labr_2x2_fs :
+                labrFData.Add(entry);
                 break;
-            }
 
-            case clover : {
-                if ( !cloverData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many clover words." << std::endl;
-                }
+            case clover :
+                cloverData.Add(entry);
                 break;
-            }
 
-            case rfchan : {
-                if ( !rfData.Add(entry) ){
-                    std::cerr << __PRETTY_FUNCTION__ << ": Too many rf words." << std::endl;
-                }
+            case rfchan :
+                rfData.Add(entry);
                 break;
-            }
             default :
                 break;
         }
     }
 }
 
-void iThembaEvent::Addback(TH2 *ab_t_clover)
+const EntryColumns *iThembaEvent::GetColumns(const DetectorType &type) const
 {
-    // We set up a vector for each clover.
-    std::vector<iThembaEntry> cevent[NUM_CLOVER_DETECTORS];
-    for ( auto &entry : cloverData.GetEntries() ){
-        cevent[entry.ID/4].push_back(entry);
+    switch ( type ){
+        case de_ring : return &ringData.GetColumns();
+        case de_sect : return &sectData.GetColumns();
+        case eDet : return &backData.GetColumns();
+        case labr_3x8 : return &labrLData.GetColumns();
+        case labr_2x2_ss : return &labrSData.GetColumns();
+        case labr_2x2_fs : return &labrFData.GetColumns();
+        case clover : return &cloverData.GetColumns();
+        case rfchan : return &rfData.GetColumns();
+        default : return nullptr;
     }
-    cloverData.Reset();
-    std::vector<iThembaEntry> v, v_new;
-    double e, tdiff;
-    for (size_t n = 0 ; n < NUM_CLOVER_DETECTORS ; ++n){
-        v = cevent[n];
-        std::sort(v.begin(), v.end(), [](const iThembaEntry &lhs, const iThembaEntry &rhs){ return lhs.energy > rhs.energy; });
-        while ( !v.empty() ){
-            v_new.clear();
-            e = v[0].energy;
-            for (size_t m = 1 ; m < v.size() ; ++m){
-                tdiff = double(v[m].tcoarse - v[0].tcoarse);
-                tdiff += (v[m].tfine - v[0].tfine);
-                ab_t_clover->Fill(tdiff, n);
-                if ( CheckTimeGateAddback(tdiff) ){
-                    e += v[m].energy;
-                } else {
-                    v_new.push_back(v[m]);
-                }
-            }
-            cloverData.Add(iThembaEntry({v[0].ID, 0, e, v[0].tfine, v[0].tcoarse, v[0].cfdvalid}));
-            v = v_new;
+}
+
+void iThembaEvent::Addback(TH2 *ab_t_clover)
+{
+    Event::Addback(cloverData.data, addbackScratch, ab_t_clover);
+}
+
+//! Telescope number of each ring, sector and back detector, indexed by detector number.
+struct TelescopeMap_t {
+    int16_t ring[NUM_SI_RING];
+    int16_t sect[NUM_SI_SECT];
+    int16_t back[NUM_SI_BACK];
+
+    TelescopeMap_t() : ring{}, sect{}, back{}
+    {
+        for ( uint16_t address = 0 ; address < TOTAL_NUMBER_OF_ADDRESSES ; ++address ){
+            DetectorInfo_t dinfo = GetDetector(address);
+            if ( dinfo.type == de_ring && dinfo.detectorNum >= 0 && dinfo.detectorNum < NUM_SI_RING )
+                ring[dinfo.detectorNum] = dinfo.telNum;
+            else if ( dinfo.type == de_sect && dinfo.detectorNum >= 0 && dinfo.detectorNum < NUM_SI_SECT )
+                sect[dinfo.detectorNum] = dinfo.telNum;
+            else if ( dinfo.type == eDet && dinfo.detectorNum >= 0 && dinfo.detectorNum < NUM_SI_BACK )
+                back[dinfo.detectorNum] = dinfo.telNum;
         }
     }
-}
\ No newline at end of file
+};
+
+//! Get the telescope map, built on first use as the detector setup may not be initialized before main.
+static const TelescopeMap_t &GetTelescopeMap()
+{
+    static const TelescopeMap_t telescope_map;
+    return telescope_map;
+}
+
+//! Find the unused dE hit of a telescope with the highest energy within the time gate of an E hit.
+static int MatchdE(const EntryColumns &dE, const int16_t *tel_map, const int &num_det, char *used,
+                   const int16_t &telescope, const EntryColumns &back, const int &b)
+{
+    int best = -1;
+    for ( int i = 0 ; i < dE.mult ; ++i ){
+        if ( used[i] || dE.ID[i] >= num_det || tel_map[dE.ID[i]] != telescope )
+            continue;
+        const double tdiff = double(dE.tcoarse[i] - back.tcoarse[b]) + (dE.tfine[i] - back.tfine[b]);
+        if ( CheckTimeGateParticle(tdiff) && ( best < 0 || dE.energy[i] > dE.energy[best] ) )
+            best = i;
+    }
+    return best;
+}
+
+void iThembaEvent::ReconstructParticles()
+{
+    particleData.Reset();
+    const EntryColumns &ring = ringData.data;
+    const EntryColumns &sect = sectData.data;
+    const EntryColumns &back = backData.data;
+    if ( ring.mult == 0 || back.mult == 0 )
+        return;
+    const TelescopeMap_t &telescope_map = GetTelescopeMap();
+
+    // Flags for the rings first, then the sectors.
+    dEused.assign(ring.mult + sect.mult, 0);
+    char *ring_used = dEused.data();
+    char *sect_used = ring_used + ring.mult;
+
+    for ( int b = 0 ; b < back.mult ; ++b ){
+        if ( back.ID[b] >= NUM_SI_BACK )
+            continue;
+        const int16_t telescope = telescope_map.back[back.ID[b]];
+
+        const int r = MatchdE(ring, telescope_map.ring, NUM_SI_RING, ring_used, telescope, back, b);
+        if ( r < 0 )
+            continue;
+        const int s = MatchdE(sect, telescope_map.sect, NUM_SI_SECT, sect_used, telescope, back, b);
+
+        ring_used[r] = 1;
+        if ( s >= 0 )
+            sect_used[s] = 1;
+
+        particleData.Add({telescope, ring.ID[r], int16_t(( s >= 0 ) ? sect.ID[s] : -1), back.ID[b],
+                          ring.energy[r], back.energy[b], GetRingAngle(ring.ID[r]),
+                          back.tfine[b], back.tcoarse[b]});
+    }
+}
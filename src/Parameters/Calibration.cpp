@@ -9,6 +9,7 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <memory>
 
 static Parameters calParam;
 
@@ -32,6 +33,24 @@ static Parameter shift_sect(calParam, "shift_sect", NUM_SI_SECT, 0);
 static Parameter gain_back(calParam, "gain_back", NUM_SI_BACK, 1);
 static Parameter shift_back(calParam, "shift_back", NUM_SI_BACK, 1);
 
+//! Polynomial energy calibration. Contains the coefficients c0 c1 c2 ... for each channel in turn,
+//! the order is given by the number of values. If given, the gain and shift of that detector type are ignored.
+static Parameter poly_labrL(calParam, "poly_labrL");
+static Parameter poly_labrS(calParam, "poly_labrS");
+static Parameter poly_labrF(calParam, "poly_labrF");
+static Parameter poly_clover(calParam, "poly_clover");
+static Parameter poly_ring(calParam, "poly_ring");
+static Parameter poly_sect(calParam, "poly_sect");
+static Parameter poly_back(calParam, "poly_back");
+
+//! Energy calibration of each address, precompiled to Horner coefficients.
+#define MAX_POLY_ORDER 3
+struct EnergyCal_t {
+    double c[MAX_POLY_ORDER+1]; //!< Polynomial coefficients, padded with zeros.
+    double dither;              //!< Amplitude of the random dithering of the raw energy.
+};
+static EnergyCal_t energy_cal[TOTAL_NUMBER_OF_ADDRESSES];
+
 //! Alignment parameters for time
 static Parameter shift_t_labrL(calParam, "shift_t_labrL", NUM_LABR_3X8_DETECTORS, 0);
 static Parameter shift_t_labrS(calParam, "shift_t_labrS", NUM_LABR_2X2_DETECTORS, 0);
@@ -41,9 +60,30 @@ static Parameter shift_t_ring(calParam, "shift_t_ring", NUM_SI_RING, 0);
 static Parameter shift_t_sect(calParam, "shift_t_sect", NUM_SI_SECT, 0);
 static Parameter shift_t_back(calParam, "shift_t_back", NUM_SI_BACK, 0);
 
+//! Time-walk parameters. The walk is given as a function of the raw energy x,
+//! t_walk(x) = p0 + p1/(x + p2) + p3*x, and is subtracted from the time.
+static Parameter walk_t_labrL(calParam, "walk_t_labrL", 4, 0);
+static Parameter walk_t_labrS(calParam, "walk_t_labrS", 4, 0);
+static Parameter walk_t_labrF(calParam, "walk_t_labrF", 4, 0);
+static Parameter walk_t_clover(calParam, "walk_t_clover", 4, 0);
+static Parameter walk_t_ring(calParam, "walk_t_ring", 4, 0);
+static Parameter walk_t_sect(calParam, "walk_t_sect", 4, 0);
+static Parameter walk_t_back(calParam, "walk_t_back", 4, 0);
+
+//! Lookup table of the time-walk for each detector type, indexed by raw energy.
+//! Only allocated for the detector types with a non-zero walk correction.
+#define WALK_TABLE_SIZE 65536
+static std::unique_ptr<float[]> walk_table[unused+1];
+
 //! Time gate for addback in clover detectors
 static Parameter clover_addback_gate(calParam, "clover_addback_gate", 2, 0);
 
+//! Time gate for matching dE ring/sector hits with E back hits, t_dE - t_E
+static Parameter particle_time_gate(calParam, "particle_time_gate", 2, 0);
+
+//! Scattering angle of each dE ring [deg]
+static Parameter angle_ring(calParam, "angle_ring", NUM_SI_RING, 0);
+
 
 bool NextLine(std::istream &in, std::string &outline, int &lineno)
 {
@@ -64,8 +104,100 @@ bool NextLine(std::istream &in, std::string &outline, int &lineno)
     return in || !line.empty();
 }
 
+void SetEnergyCal(EnergyCal_t &cal, const Parameter &gain, const Parameter &shift, const Parameter &poly,
+                  const int &nchannels, const int &idx)
+{
+    cal = {{0, 0, 0, 0}, 1};
+    int ncoeff = poly.GetSize()/nchannels;
+    if ( poly.GetSize() > 0 && ( poly.GetSize() % nchannels != 0 || ncoeff > MAX_POLY_ORDER+1 ) ){
+        std::cerr << "Warning: Polynomial calibration '" << poly.GetName() << "' should have up to ";
+        std::cerr << MAX_POLY_ORDER+1 << " coefficients for each of the " << nchannels;
+        std::cerr << " channels, using gain and shift." << std::endl;
+        ncoeff = 0;
+    }
+    if ( ncoeff > 0 ){
+        for ( int i = 0 ; i < ncoeff ; ++i )
+            cal.c[i] = poly[idx*ncoeff + i];
+    } else {
+        cal.c[0] = shift[idx];
+        cal.c[1] = gain[idx];
+    }
+}
+
+void BuildEnergyCal()
+{
+    for ( uint16_t address = 0 ; address < TOTAL_NUMBER_OF_ADDRESSES ; ++address ){
+        DetectorInfo_t dinfo = GetDetector(address);
+        EnergyCal_t &cal = energy_cal[address];
+        switch ( dinfo.type ) {
+            case labr_3x8 :
+                SetEnergyCal(cal, gain_labrL, shift_labrL, poly_labrL, NUM_LABR_3X8_DETECTORS, dinfo.detectorNum);
+                break;
+            case labr_2x2_ss :
+                SetEnergyCal(cal, gain_labrS, shift_labrS, poly_labrS, NUM_LABR_2X2_DETECTORS, dinfo.detectorNum);
+                break;
+            case labr_2x2_fs :
+                SetEnergyCal(cal, gain_labrF, shift_labrF, poly_labrF, NUM_LABR_2X2_DETECTORS, dinfo.detectorNum);
+                break;
+            case clover :
+                SetEnergyCal(cal, gain_clover, shift_clover, poly_clover, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS,
+                             dinfo.detectorNum*NUM_CLOVER_CRYSTALS+dinfo.telNum);
+                break;
+            case de_ring :
+                SetEnergyCal(cal, gain_ring, shift_ring, poly_ring, NUM_SI_RING, dinfo.detectorNum);
+                break;
+            case de_sect :
+                SetEnergyCal(cal, gain_sect, shift_sect, poly_sect, NUM_SI_SECT, dinfo.detectorNum);
+                break;
+            case eDet :
+                SetEnergyCal(cal, gain_back, shift_back, poly_back, NUM_SI_BACK, dinfo.detectorNum);
+                break;
+            default :
+                cal = {{0, 1, 0, 0}, 0};
+                break;
+        }
+    }
+}
+
+void BuildWalkTable(const Parameter &walk, const DetectorType &type)
+{
+    if ( walk[0] == 0 && walk[1] == 0 && walk[3] == 0 ){
+        walk_table[type].reset();
+        return;
+    }
+    if ( !walk_table[type] )
+        walk_table[type].reset(new float[WALK_TABLE_SIZE]);
+    double x;
+    for ( int i = 0 ; i < WALK_TABLE_SIZE ; ++i ){
+        x = i + walk[2];
+        walk_table[type][i] = float(walk[0] + ( ( x > 0 ) ? walk[1]/x : 0 ) + walk[3]*i);
+    }
+}
+
+void BuildTimeCal()
+{
+    BuildWalkTable(walk_t_labrL, labr_3x8);
+    BuildWalkTable(walk_t_labrS, labr_2x2_ss);
+    BuildWalkTable(walk_t_labrF, labr_2x2_fs);
+    BuildWalkTable(walk_t_clover, clover);
+    BuildWalkTable(walk_t_ring, de_ring);
+    BuildWalkTable(walk_t_sect, de_sect);
+    BuildWalkTable(walk_t_back, eDet);
+}
+
+//! Make sure the lookup tables are valid also when no calibration file is loaded.
+//! The tables are built on first use, as the detector setup may not be initialized before main.
+inline void CheckCalibrationBuilt()
+{
+    static const bool built = ( BuildEnergyCal(), BuildTimeCal(), true );
+    (void)built;
+}
+
 bool SetCalibration(const char *calfile)
 {
+    // Build the default tables first, such that the first use doesn't replace the tables built below.
+    CheckCalibrationBuilt();
+
     // Open file
     std::ifstream inCal(calfile);
     std::string currentLine;
@@ -81,42 +213,49 @@ bool SetCalibration(const char *calfile)
             return false;
         }
     }
-    // Make sure we have time calibration on the correct format.
-    //BuildTimeCal();
+    // Make sure we have energy and time calibration on the correct format.
+    BuildEnergyCal();
+    BuildTimeCal();
     return true;
 }
 
+bool WriteCalibration(const char *calfile)
+{
+    std::ofstream outCal(calfile);
+    if ( !outCal.is_open() ){
+        std::cerr << "Unable to open calibration file '" << calfile << "' for writing." << std::endl;
+        return false;
+    }
+    outCal.precision(10);
+    calParam.Write(outCal);
+    return bool(outCal);
+}
+
+Parameter *GetCalibrationParameter(const std::string &name)
+{
+    return calParam.Find(name);
+}
+
+inline double CalibrateEnergy(const EnergyCal_t &cal, const uint16_t &adcdata, const double &rnd)
+{
+    double x = adcdata + cal.dither*(rnd - 0.5);
+    return ((cal.c[3]*x + cal.c[2])*x + cal.c[1])*x + cal.c[0];
+}
+
 double CalibrateEnergy(const Parser::Entry_t &detector)
 {
-    double energy = 0;
-    DetectorInfo_t dinfo = GetDetector(detector.address);
-    switch (dinfo.type) {
-        case labr_3x8 :
-            energy = gain_labrL[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_labrL[dinfo.detectorNum];
-            break;
-        case labr_2x2_ss :
-            energy = gain_labrS[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_labrS[dinfo.detectorNum];
-            break;
-        case labr_2x2_fs :
-            energy = gain_labrF[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_labrF[dinfo.detectorNum];
-            break;
-        case clover :
-            energy = gain_clover[dinfo.detectorNum*NUM_CLOVER_CRYSTALS+dinfo.telNum]*(detector.adcdata + drand48() - 0.5) + shift_clover[dinfo.detectorNum*NUM_CLOVER_CRYSTALS+dinfo.telNum];
-            break;
-        case de_ring :
-            energy = gain_ring[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_ring[dinfo.detectorNum];
-            break;
-        case de_sect :
-            energy = gain_sect[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_sect[dinfo.detectorNum];
-            break;
-        case eDet :
-            energy = gain_back[dinfo.detectorNum]*(detector.adcdata + drand48() - 0.5) + shift_back[dinfo.detectorNum];
-            break;
-        default :
-            energy = detector.adcdata;
-            break;
+    CheckCalibrationBuilt();
+    const EnergyCal_t &cal = energy_cal[( detector.address < TOTAL_NUMBER_OF_ADDRESSES ) ? detector.address : 0];
+    return CalibrateEnergy(cal, detector.adcdata, drand48());
+}
+
+void CalibrateEnergy(Parser::Entry_t *entries, const size_t &size)
+{
+    CheckCalibrationBuilt();
+    for ( size_t i = 0 ; i < size ; ++i ){
+        const EnergyCal_t &cal = energy_cal[( entries[i].address < TOTAL_NUMBER_OF_ADDRESSES ) ? entries[i].address : 0];
+        entries[i].energy = CalibrateEnergy(cal, entries[i].adcdata, drand48());
     }
-    return energy;
 }
 
 double CalibrateCFD(const Parser::Entry_t &detector, int64_t &timestamp, bool &cfdfail)
@@ -180,46 +319,68 @@ double CalibrateCFD(const Parser::Entry_t &detector, int64_t &timestamp, bool &c
 
 double CalTime(const Parser::Entry_t &detector)
 {
+    CheckCalibrationBuilt();
     DetectorInfo_t dinfo = GetDetector(detector.address);
-    double time = 0;
+    const float *walk = walk_table[dinfo.type].get();
+    double time = ( walk ) ? -walk[detector.adcdata] : 0;
     switch (dinfo.type) {
         case labr_3x8 :
-            time = detector.cfdcorr + shift_t_labrL[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_labrL[dinfo.detectorNum];
             break;
         case labr_2x2_ss :
-            time = detector.cfdcorr + shift_t_labrS[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_labrS[dinfo.detectorNum];
             break;
         case labr_2x2_fs :
-            time = detector.cfdcorr + shift_t_labrF[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_labrF[dinfo.detectorNum];
             break;
         case clover :
-            time = detector.cfdcorr + shift_t_clover[dinfo.detectorNum*NUM_CLOVER_CRYSTALS + dinfo.telNum];
+            time += detector.cfdcorr + shift_t_clover[dinfo.detectorNum*NUM_CLOVER_CRYSTALS + dinfo.telNum];
             break;
         case de_ring :
-            time = detector.cfdcorr + shift_t_ring[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_ring[dinfo.detectorNum];
             break;
         case de_sect :
-            time = detector.cfdcorr + shift_t_sect[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_sect[dinfo.detectorNum];
             break;
         case eDet :
-            time = detector.cfdcorr + shift_t_back[dinfo.detectorNum];
+            time += detector.cfdcorr + shift_t_back[dinfo.detectorNum];
             break;
         default :
-            time = detector.cfdcorr;
+            time += detector.cfdcorr;
             break;
     }
     return time;
 }
 
-Parser::Entry_t &Calibrate(Parser::Entry_t &entry)
+Parser::Entry_t &CalibrateTime(Parser::Entry_t &entry)
 {
-    entry.energy = CalibrateEnergy(entry);
     entry.cfdcorr = CalibrateCFD(entry, entry.timestamp, entry.cfdfail);
     entry.cfdcorr = CalTime(entry);
     return entry;
 }
 
+Parser::Entry_t &Calibrate(Parser::Entry_t &entry)
+{
+    entry.energy = CalibrateEnergy(entry);
+    return CalibrateTime(entry);
+}
+
 bool CheckTimeGateAddback(const double &timediff)
 {
    return timediff >= clover_addback_gate[0] && timediff <= clover_addback_gate[1];
 }
+
+bool CheckTimeGateParticle(const double &timediff)
+{
+    return timediff >= particle_time_gate[0] && timediff <= particle_time_gate[1];
+}
+
+bool HasTimeGateParticle()
+{
+    return particle_time_gate[1] > particle_time_gate[0];
+}
+
+double GetRingAngle(const int &ring)
+{
+    return angle_ring[ring];
+}
@@ -0,0 +1,132 @@
+#include "Parameters/GainMatch.h"
+#include "Parameters/Calibration.h"
+#include "Parameters/Parameters.h"
+#include "Parameters/PeakFinder.h"
+#include "Parameters/experimentsetup.h"
+
+#include <algorithm>
+#include <iostream>
+
+GainMatch::GainMatch(const std::vector<double> &source_lines, const int &ref_channel, const int &threshold_channel)
+    : energy_ring( 16384, -0.5, 16383.5, NUM_SI_RING )
+    , energy_sect( 16384, -0.5, 16383.5, NUM_SI_SECT )
+    , energy_back( 16384, -0.5, 16383.5, NUM_SI_BACK )
+    , energy_labrL( 16384, -0.5, 16383.5, NUM_LABR_3X8_DETECTORS )
+    , energy_labrS( 16384, -0.5, 16383.5, NUM_LABR_2X2_DETECTORS )
+    , energy_labrF( 16384, -0.5, 16383.5, NUM_LABR_2X2_DETECTORS )
+    , energy_clover( 16384, -0.5, 16383.5, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS )
+    , lines( source_lines )
+    , reference( ref_channel )
+    , threshold( threshold_channel )
+{
+    std::sort(lines.begin(), lines.end());
+}
+
+Histogram2D *GainMatch::GetHistogram(const Parser::Entry_t &entry, int &id)
+{
+    DetectorInfo_t dinfo = GetDetector(entry.address);
+    id = dinfo.detectorNum;
+    switch ( dinfo.type ) {
+        case de_ring : return &energy_ring;
+        case de_sect : return &energy_sect;
+        case eDet : return &energy_back;
+        case labr_3x8 : return &energy_labrL;
+        case labr_2x2_ss : return &energy_labrS;
+        case labr_2x2_fs : return &energy_labrF;
+        case clover :
+            id = dinfo.detectorNum*NUM_CLOVER_CRYSTALS + dinfo.telNum;
+            return &energy_clover;
+        default :
+            return nullptr;
+    }
+}
+
+void GainMatch::Fill(const std::vector<Parser::Entry_t> &entries)
+{
+    Histogram2D *hist;
+    int id;
+    for ( auto &entry : entries ){
+        if ( (hist = GetHistogram(entry, id)) != nullptr )
+            hist->FillBin(entry.adcdata, id);
+    }
+}
+
+int GainMatch::Match(const Histogram2D &hist, const char *gain_name, const char *shift_name)
+{
+    Parameter *gain = GetCalibrationParameter(gain_name);
+    Parameter *shift = GetCalibrationParameter(shift_name);
+    if ( !gain || !shift || reference < 0 || reference >= hist.GetYbins() )
+        return 0;
+
+    std::vector<double> gains(gain->GetSize()), shifts(shift->GetSize());
+    for ( int i = 0 ; i < gain->GetSize() ; ++i )
+        gains[i] = gain->Get(i);
+    for ( int i = 0 ; i < shift->GetSize() ; ++i )
+        shifts[i] = shift->Get(i);
+
+    // The energies we want the peaks to end up at. Either the source lines or
+    // the reference channel peaks calibrated with the current calibration.
+    std::vector<double> energies = lines;
+    std::vector<Peak_t> peaks(std::max(energies.size(), size_t(2)));
+    if ( energies.empty() ){
+        const uint32_t *row = hist.GetRow(reference);
+        if ( std::find_if(row, row + hist.GetXbins(), [](const uint32_t &c){ return c > 0; }) == row + hist.GetXbins() )
+            return 0; // No data for this detector type
+        int npeaks = FindPeaks(hist.GetRow(reference), hist.GetXbins(), hist.GetXmin(), hist.GetBinWidth(),
+                               peaks.data(), 2, threshold);
+        for ( int i = 0 ; i < npeaks ; ++i )
+            energies.push_back(gain->Get(reference)*peaks[i].centroid + shift->Get(reference));
+        if ( energies.empty() ){
+            std::cerr << "Warning: No peaks found in reference channel " << reference << " of " << gain_name << std::endl;
+            return 0;
+        }
+    }
+
+    int matched = 0;
+    for ( int i = 0 ; i < hist.GetYbins() && i < gain->GetSize() && i < shift->GetSize() ; ++i ){
+        const uint32_t *row = hist.GetRow(i);
+        if ( std::find_if(row, row + hist.GetXbins(), [](const uint32_t &c){ return c > 0; }) == row + hist.GetXbins() )
+            continue; // No data for this channel
+
+        int npeaks = FindPeaks(row, hist.GetXbins(), hist.GetXmin(), hist.GetBinWidth(),
+                               peaks.data(), int(energies.size()), threshold);
+        if ( npeaks != int(energies.size()) ){
+            std::cerr << "Warning: Found " << npeaks << " of " << energies.size() << " peaks in ";
+            std::cerr << gain_name << "[" << i << "], calibration unchanged." << std::endl;
+            continue;
+        }
+
+        if ( npeaks == 1 ){
+            gains[i] = energies[0]/peaks[0].centroid;
+            shifts[i] = 0;
+        } else {
+            // Linear least squares fit of energy vs. channel.
+            double sx = 0, sy = 0, sxx = 0, sxy = 0;
+            for ( int n = 0 ; n < npeaks ; ++n ){
+                sx += peaks[n].centroid;
+                sy += energies[n];
+                sxx += peaks[n].centroid*peaks[n].centroid;
+                sxy += peaks[n].centroid*energies[n];
+            }
+            gains[i] = (npeaks*sxy - sx*sy)/(npeaks*sxx - sx*sx);
+            shifts[i] = (sy - gains[i]*sx)/npeaks;
+        }
+        ++matched;
+    }
+    gain->Set(gains);
+    shift->Set(shifts);
+    return matched;
+}
+
+int GainMatch::Solve()
+{
+    int matched = 0;
+    matched += Match(energy_ring, "gain_ring", "shift_ring");
+    matched += Match(energy_sect, "gain_sect", "shift_sect");
+    matched += Match(energy_back, "gain_back", "shift_back");
+    matched += Match(energy_labrL, "gain_labrL", "shift_labrL");
+    matched += Match(energy_labrS, "gain_labrS", "shift_labrS");
+    matched += Match(energy_labrF, "gain_labrF", "shift_labrF");
+    matched += Match(energy_clover, "gain_clover", "shift_clover");
+    return matched;
+}
@@ -133,6 +133,18 @@ bool Parameters::SetAll(std::istringstream& icmd)
     return true;
 }
 
+// ########################################################################
+
+void Parameters::Write(std::ostream& out) const
+{
+    for( names_t::const_iterator it = names.begin(); it != names.end(); ++it ) {
+        out << it->first << " =";
+        for(int i=0; i < it->second->GetSize(); ++i)
+            out << ' ' << it->second->Get(i);
+        out << '\n';
+    }
+}
+
 // ########################################################################
 // ########################################################################
 
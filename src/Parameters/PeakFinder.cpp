@@ -0,0 +1,74 @@
+#include "Parameters/PeakFinder.h"
+
+#include <algorithm>
+#include <vector>
+
+bool FindPeak(const uint32_t *counts, const int &nbins, const double &xmin, const double &width,
+              Peak_t &peak, const double &min_area)
+{
+    if ( nbins <= 0 )
+        return false;
+
+    int max_bin = int(std::max_element(counts, counts + nbins) - counts);
+    double half_max = 0.5*counts[max_bin];
+    if ( counts[max_bin] == 0 )
+        return false;
+
+    // Walk down to half maximum on each side.
+    int low = max_bin, high = max_bin;
+    while ( low > 0 && counts[low - 1] > half_max )
+        --low;
+    while ( high < nbins - 1 && counts[high + 1] > half_max )
+        ++high;
+    int hw = std::max((high - low + 1)/2, 1);
+
+    // Peak region is within one FWHM of the maximum, background region is the next FWHM on each side.
+    int pstart = std::max(max_bin - 2*hw, 0), pstop = std::min(max_bin + 2*hw, nbins - 1);
+    int bstart = std::max(pstart - 2*hw, 0), bstop = std::min(pstop + 2*hw, nbins - 1);
+
+    double bkg = 0;
+    int nbkg = 0;
+    for ( int i = bstart ; i < pstart ; ++i, ++nbkg )
+        bkg += counts[i];
+    for ( int i = pstop + 1 ; i <= bstop ; ++i, ++nbkg )
+        bkg += counts[i];
+    bkg = ( nbkg > 0 ) ? bkg/nbkg : 0;
+
+    double sum = 0, wsum = 0, c;
+    for ( int i = pstart ; i <= pstop ; ++i ){
+        c = std::max(counts[i] - bkg, 0.);
+        sum += c;
+        wsum += c*(xmin + (i + 0.5)*width);
+    }
+
+    if ( sum < min_area )
+        return false;
+
+    peak.centroid = wsum/sum;
+    peak.fwhm = (high - low + 1)*width;
+    peak.area = sum;
+    return true;
+}
+
+int FindPeaks(const uint32_t *counts, const int &nbins, const double &xmin, const double &width,
+              Peak_t *peaks, const int &max_peaks, const int &first_bin, const double &min_area)
+{
+    if ( first_bin >= nbins )
+        return 0;
+
+    std::vector<uint32_t> work(counts + std::max(first_bin, 0), counts + nbins);
+    double wxmin = xmin + std::max(first_bin, 0)*width;
+    int found = 0;
+    Peak_t peak = {0, 0, 0};
+    while ( found < max_peaks && FindPeak(work.data(), int(work.size()), wxmin, width, peak, min_area) ){
+        peaks[found++] = peak;
+
+        // Mask out the peak before looking for the next one.
+        int center = int((peak.centroid - wxmin)/width);
+        int hw = std::max(int(peak.fwhm/width), 1);
+        for ( int i = std::max(center - 2*hw, 0) ; i <= std::min(center + 2*hw, int(work.size()) - 1) ; ++i )
+            work[i] = 0;
+    }
+    std::sort(peaks, peaks + found, [](const Peak_t &lhs, const Peak_t &rhs){ return lhs.centroid < rhs.centroid; });
+    return found;
+}
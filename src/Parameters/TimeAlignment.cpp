@@ -0,0 +1,120 @@
+#include "Parameters/TimeAlignment.h"
+#include "Parameters/Calibration.h"
+#include "Parameters/Parameters.h"
+#include "Parameters/PeakFinder.h"
+#include "Parameters/experimentsetup.h"
+
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+TimeAlignment::TimeAlignment(const double &time_window, const DetectorType &ref_type, const int &ref_num)
+    : time_ring( 3000, -1500, 1500, NUM_SI_RING )
+    , time_sect( 3000, -1500, 1500, NUM_SI_SECT )
+    , time_back( 3000, -1500, 1500, NUM_SI_BACK )
+    , time_labrL( 30000, -1500, 1500, NUM_LABR_3X8_DETECTORS )
+    , time_labrS( 3000, -1500, 1500, NUM_LABR_2X2_DETECTORS )
+    , time_labrF( 30000, -1500, 1500, NUM_LABR_2X2_DETECTORS )
+    , time_clover( 3000, -1500, 1500, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS )
+    , window( time_window )
+    , reference_type( ref_type )
+    , reference_num( ref_num )
+    , reference_count( 0 )
+{
+}
+
+Histogram2D *TimeAlignment::GetHistogram(const Parser::Entry_t &entry, int &id)
+{
+    DetectorInfo_t dinfo = GetDetector(entry.address);
+    id = dinfo.detectorNum;
+    switch ( dinfo.type ) {
+        case de_ring : return &time_ring;
+        case de_sect : return &time_sect;
+        case eDet : return &time_back;
+        case labr_3x8 : return &time_labrL;
+        case labr_2x2_ss : return &time_labrS;
+        case labr_2x2_fs : return &time_labrF;
+        case clover :
+            id = dinfo.detectorNum*NUM_CLOVER_CRYSTALS + dinfo.telNum;
+            return &time_clover;
+        default :
+            return nullptr;
+    }
+}
+
+inline double TimeDiff(const Parser::Entry_t &lhs, const Parser::Entry_t &rhs)
+{
+    return double(lhs.timestamp - rhs.timestamp) + (lhs.cfdcorr - rhs.cfdcorr);
+}
+
+void TimeAlignment::Fill(const std::vector<Parser::Entry_t> &entries)
+{
+    Histogram2D *hist;
+    int id;
+    size_t first = 0;
+    for ( size_t n = 0 ; n < entries.size() ; ++n ){
+        const Parser::Entry_t &ref = entries[n];
+        DetectorInfo_t dinfo = GetDetector(ref.address);
+        if ( dinfo.type != reference_type || dinfo.detectorNum != reference_num || ref.cfdfail )
+            continue;
+        ++reference_count;
+
+        // The entries are time ordered, hence the start of the window only moves forward.
+        while ( first < n && TimeDiff(ref, entries[first]) > window )
+            ++first;
+
+        for ( size_t m = first ; m < entries.size() ; ++m ){
+            double tdiff = TimeDiff(entries[m], ref);
+            if ( tdiff > window )
+                break;
+            if ( entries[m].address == ref.address )
+                continue;
+            if ( (hist = GetHistogram(entries[m], id)) != nullptr )
+                hist->Fill(tdiff, id);
+        }
+    }
+}
+
+int TimeAlignment::Align(const Histogram2D &hist, const char *param_name)
+{
+    Parameter *param = GetCalibrationParameter(param_name);
+    if ( !param )
+        return 0;
+
+    std::vector<double> shifts(param->GetSize());
+    for ( int i = 0 ; i < param->GetSize() ; ++i )
+        shifts[i] = param->Get(i);
+
+    Peak_t peak = {0, 0, 0};
+    int aligned = 0;
+    for ( int i = 0 ; i < hist.GetYbins() && i < param->GetSize() ; ++i ){
+        const uint32_t *row = hist.GetRow(i);
+        if ( std::find_if(row, row + hist.GetXbins(), [](const uint32_t &c){ return c > 0; }) == row + hist.GetXbins() )
+            continue; // No data for this channel
+        if ( FindPeak(hist.GetRow(i), hist.GetXbins(), hist.GetXmin(), hist.GetBinWidth(), peak) ){
+            shifts[i] -= peak.centroid;
+            ++aligned;
+        } else {
+            std::cerr << "Warning: No prompt peak found for " << param_name << "[" << i << "], shift unchanged." << std::endl;
+        }
+    }
+    param->Set(shifts);
+    return aligned;
+}
+
+int TimeAlignment::Solve()
+{
+    if ( reference_count == 0 )
+        throw std::runtime_error("No entries from reference detector " + std::to_string(reference_num) +
+                                 " found, unable to align the time");
+    int aligned = 0;
+    aligned += Align(time_ring, "shift_t_ring");
+    aligned += Align(time_sect, "shift_t_sect");
+    aligned += Align(time_back, "shift_t_back");
+    aligned += Align(time_labrL, "shift_t_labrL");
+    aligned += Align(time_labrS, "shift_t_labrS");
+    aligned += Align(time_labrF, "shift_t_labrF");
+    aligned += Align(time_clover, "shift_t_clover");
+    return aligned;
+}
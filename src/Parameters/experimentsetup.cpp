@@ -570,3 +570,18 @@ enum ADCSamplingFreq GetSamplingFrequency(const uint16_t& address)
 {
     return (address < TOTAL_NUMBER_OF_ADDRESSES) ? pDetector[address].sfreq : f000MHz;
 }
+
+int16_t GetFlatID(const uint16_t &address)
+{
+    const DetectorInfo_t info = GetDetector(address);
+    return ( info.type != clover ) ? info.detectorNum : int16_t(info.detectorNum*NUM_CLOVER_CRYSTALS + info.telNum);
+}
+
+unsigned GetPresentTypes()
+{
+    unsigned types = 0;
+    for ( int i = 0 ; i < TOTAL_NUMBER_OF_ADDRESSES ; ++i ){
+        types |= 1u << pDetector[i].type;
+    }
+    return types;
+}
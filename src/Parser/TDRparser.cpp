@@ -33,7 +33,7 @@ Entry_t MakeEntry(const TDR_entry &adc, const TDR_entry &tdc)
                    0,
                    false,
                    false};
-    return Calibrate(ret);
+    return CalibrateTime(ret);
 }
 
 Entry_t MakeStandAloneEntry(const TDR_entry &adc)
@@ -46,7 +46,7 @@ Entry_t MakeStandAloneEntry(const TDR_entry &adc)
                    0,
                    false,
                    false};
-    return Calibrate(ret);
+    return CalibrateTime(ret);
 }
 
 int64_t FindTopTime(const uint64_t *raw, const size_t &size)
@@ -123,6 +123,8 @@ std::vector<Entry_t> TDRparser::SortMerge(std::vector<TDR_entry> &entries)
     std::sort(std::begin(res), std::end(res), [](const Entry_t &lhs, const Entry_t &rhs){
         return ( double( lhs.timestamp - rhs.timestamp ) + ( lhs.cfdcorr  - rhs.cfdcorr ) ) < 0;});
 
+    CalibrateEnergy(res.data(), res.size());
+
     leftover_entries = keep;
     return res;
 }
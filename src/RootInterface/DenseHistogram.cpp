@@ -0,0 +1,32 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/DenseHistogram.h"
+
+#include <TH2.h>
+
+DenseTH2::DenseTH2(TH2 *h)
+    : hist( h )
+    , counts( h->GetXaxis()->GetNbins(), h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax(),
+              h->GetYaxis()->GetNbins(), h->GetYaxis()->GetXmin(), h->GetYaxis()->GetXmax() )
+    , entries( 0 )
+{
+}
+
+void DenseTH2::Flush()
+{
+    if ( entries == 0 )
+        return;
+
+    for ( int y = 0 ; y < counts.GetYbins() ; ++y ){
+        const uint32_t *row = counts.GetRow(y);
+        for ( int x = 0 ; x < counts.GetXbins() ; ++x ){
+            if ( row[x] > 0 )
+                hist->AddBinContent(hist->GetBin(x + 1, y + 1), row[x]);
+        }
+    }
+    hist->SetEntries(hist->GetEntries() + entries);
+    counts.Reset();
+    entries = 0;
+}
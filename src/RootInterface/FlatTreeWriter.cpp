@@ -0,0 +1,44 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/FlatTreeWriter.h"
+
+#include <Parameters/experimentsetup.h>
+
+#include <TTree.h>
+
+FlatTreeWriter::FlatTreeWriter(RootFileManager *fm, const char *name, const char *title)
+    : tree( fm->CreateTree(name, title) )
+    , address( 0 ), ID( 0 ), type( 0 ), e_raw( 0 ), energy( 0 ), tcoarse( 0 ), tfine( 0 )
+    , cfdfail( false ), pileup( false )
+{
+    tree->Branch("address", &address, "address/s");
+    tree->Branch("ID", &ID, "ID/S");
+    tree->Branch("type", &type, "type/b");
+    tree->Branch("e_raw", &e_raw, "e_raw/s");
+    tree->Branch("energy", &energy, "energy/D");
+    tree->Branch("tcoarse", &tcoarse, "tcoarse/L");
+    tree->Branch("tfine", &tfine, "tfine/D");
+    tree->Branch("cfdfail", &cfdfail, "cfdfail/O");
+    tree->Branch("pileup", &pileup, "pileup/O");
+    if ( fm->GetOptions().basket_size > 0 )
+        tree->SetBasketSize("*", fm->GetOptions().basket_size);
+}
+
+void FlatTreeWriter::Write(const Parser::Entry_t *entries, const size_t &size)
+{
+    for ( size_t n = 0 ; n < size ; ++n ){
+        const Parser::Entry_t &entry = entries[n];
+        address = entry.address;
+        ID = GetFlatID(entry.address);
+        type = uint8_t(GetDetectorType(entry.address));
+        e_raw = entry.adcdata;
+        energy = entry.energy;
+        tcoarse = entry.timestamp;
+        tfine = entry.cfdcorr;
+        cfdfail = entry.cfdfail;
+        pileup = entry.finishcode;
+        tree->Fill();
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/FlatWriter.h"
+
+#include <Parameters/experimentsetup.h>
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+FlatBinaryWriter::FlatBinaryWriter(const char *base_name)
+    : base( base_name )
+    , columns( {{"address", "u2", nullptr}, {"ID", "i2", nullptr}, {"type", "u1", nullptr},
+                {"e_raw", "u2", nullptr}, {"energy", "f8", nullptr}, {"tcoarse", "i8", nullptr},
+                {"tfine", "f8", nullptr}, {"cfdfail", "u1", nullptr}, {"pileup", "u1", nullptr}} )
+    , rows( 0 )
+{
+    for ( auto &column : columns ){
+        const std::string fname = base + "." + column.name;
+        column.file = fopen(fname.c_str(), "wb");
+        if ( !column.file ){
+            for ( auto &opened : columns ){
+                if ( opened.file )
+                    fclose(opened.file);
+            }
+            throw std::runtime_error("Unable to open '" + fname + "'");
+        }
+    }
+    address.reserve(batch_size);
+    ID.reserve(batch_size);
+    type.reserve(batch_size);
+    e_raw.reserve(batch_size);
+    energy.reserve(batch_size);
+    tcoarse.reserve(batch_size);
+    tfine.reserve(batch_size);
+    cfdfail.reserve(batch_size);
+    pileup.reserve(batch_size);
+}
+
+FlatBinaryWriter::~FlatBinaryWriter()
+{
+    try {
+        Flush();
+    } catch ( const std::runtime_error &e ){
+        std::cerr << "Warning: " << e.what() << std::endl;
+    }
+    std::ofstream list(base + ".columns");
+    for ( auto &column : columns ){
+        fclose(column.file);
+        list << column.name << " " << column.type << " " << rows << "\n";
+    }
+}
+
+void FlatBinaryWriter::Flush()
+{
+    if ( address.empty() )
+        return;
+
+    const void *data[] = {address.data(), ID.data(), type.data(), e_raw.data(), energy.data(),
+                          tcoarse.data(), tfine.data(), cfdfail.data(), pileup.data()};
+    const size_t sizes[] = {sizeof(uint16_t), sizeof(int16_t), sizeof(uint8_t), sizeof(uint16_t), sizeof(double),
+                            sizeof(int64_t), sizeof(double), sizeof(uint8_t), sizeof(uint8_t)};
+    for ( size_t i = 0 ; i < columns.size() ; ++i ){
+        if ( fwrite(data[i], sizes[i], address.size(), columns[i].file) != address.size() )
+            throw std::runtime_error("Unable to write to '" + base + "." + columns[i].name + "'");
+    }
+    rows += address.size();
+
+    address.clear();
+    ID.clear();
+    type.clear();
+    e_raw.clear();
+    energy.clear();
+    tcoarse.clear();
+    tfine.clear();
+    cfdfail.clear();
+    pileup.clear();
+}
+
+void FlatBinaryWriter::Write(const Parser::Entry_t *entries, const size_t &size)
+{
+    for ( size_t n = 0 ; n < size ; ++n ){
+        const Parser::Entry_t &entry = entries[n];
+        address.push_back(entry.address);
+        ID.push_back(GetFlatID(entry.address));
+        type.push_back(uint8_t(GetDetectorType(entry.address)));
+        e_raw.push_back(entry.adcdata);
+        energy.push_back(entry.energy);
+        tcoarse.push_back(entry.timestamp);
+        tfine.push_back(entry.cfdcorr);
+        cfdfail.push_back(entry.cfdfail);
+        pileup.push_back(entry.finishcode);
+        if ( address.size() == batch_size )
+            Flush();
+    }
+}
@@ -25,107 +25,111 @@
 #include <TH2.h>
 #include <Event/iThembaEvent.h>
 
-HistManager::HistManager(RootFileManager *fm)
-    : time_ring( fm->CreateTH2("time_ring", "Time spectra rings", 3000, -1500, 1500, "Time [ns]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-    , time_sect( fm->CreateTH2("time_sect", "Time spectra sectors", 3000, -1500, 1500, "Time [ns]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-    , time_back( fm->CreateTH2("time_back", "Time spectra back detector", 3000, -1500, 1500, "Time [ns]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-    , time_labrL( fm->CreateTH2("time_labrL", "Time spectra LaBr L", 30000, -1500, 1500, "Time [ns]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-    , time_labrS( fm->CreateTH2("time_labrS", "Time spectra LaBr S", 3000, -1500, 1500, "Time [ns]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-    , time_labrF( fm->CreateTH2("time_labrF", "Time spectra LaBr F", 30000, -1500, 1500, "Time [ns]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-    , time_clover( fm->CreateTH2("time_clover", "Time spectra CLOVER", 3000, -1500, 1500, "Time [ns]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-    , time_energy_sect_back( fm->CreateTH2("time_energy_sect_back", "Energy vs. sector/back time", 1000, 0, 30000, "E energy [keV]", 3000, -1500, 1500, "t_{back} - t_{sector} [ns]") )
-    , time_energy_ring_sect( fm->CreateTH2("time_energy_ring_sect", "Energy vs. sector/back time", 1000, 0, 30000, "Sector energy [keV]", 3000, -1500, 1500, "t_{ring} - t_{sector} [ns]") )
-    , energy_ring( fm->CreateTH2("energy_ring", "Energy spectra rings", 16384, 0, 16384, "Energy [ch]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-    , energy_sect( fm->CreateTH2("energy_sect", "Energy spectra sectors", 16384, 0, 16384, "Energy [ch]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-    , energy_back( fm->CreateTH2("energy_back", "Energy spectra back detectors", 16384, 0, 16384, "Energy [ch]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-    , energy_labrL( fm->CreateTH2("energy_labrL", "Energy spectra LaBr L", 16384, 0, 16384, "Energy [ch]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-    , energy_labrS( fm->CreateTH2("energy_labrS", "Energy spectra LaBr S", 16384, 0, 16384, "Energy [ch]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-    , energy_labrF( fm->CreateTH2("energy_labrF", "Energy spectra LaBr F", 16384, 0, 16384, "Energy [ch]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-    , energy_clover( fm->CreateTH2("energy_clover", "Energy spectra CLOVER", 16384, 0, 16384, "Energy [ch]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-    , energy_cal_ring( fm->CreateTH2("energy_cal_ring", "Energy spectra rings", 16384, 0, 16384, "Energy [keV]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-    , energy_cal_sect( fm->CreateTH2("energy_cal_sect", "Energy spectra sectors", 16384, 0, 16384, "Energy [keV]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-    , energy_cal_back( fm->CreateTH2("energy_cal_back", "Energy spectra back detectors", 16384, 0, 16384, "Energy [keV]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-    , energy_cal_labrL( fm->CreateTH2("energy_cal_labrL", "Energy spectra LaBr L", 16384, 0, 16384, "Energy [keV]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-    , energy_cal_labrS( fm->CreateTH2("energy_cal_labrS", "Energy spectra LaBr S", 16384, 0, 16384, "Energy [keV]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-    , energy_cal_labrF( fm->CreateTH2("energy_cal_labrF", "Energy spectra LaBr F", 16384, 0, 16384, "Energy [keV]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-    , energy_cal_clover( fm->CreateTH2("energy_cal_clover", "Energy spectra CLOVER", 16384, 0, 16384, "Energy [keV]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-    , addback_hist( fm->CreateTH2("time_self_clover", "Time spectra, clover self timing",3000, -1500, 1500, "Time [ns]",NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+HistManager::HistManager(RootFileManager *fm, const std::vector<HistogramDefinition> &definitions)
+    : addback_hist( fm->CreateTH2("time_self_clover", "Time spectra, clover self timing",3000, -1500, 1500, "Time [ns]",NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+    , energy_addback_clover( fm->CreateTH2("energy_ab_clover", "Energy spectra CLOVER after addback", 16384, 0, 16384, "Energy [keV]", NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+    , ede_particle( fm->CreateTH2("ede_particle", "dE-E spectrum of reconstructed particles", 1000, 0, 30000, "E energy [keV]", 1000, 0, 15000, "dE energy [keV]") )
 {
+    Setup(fm, definitions);
 }
 
 #if ROOT_MT_FLAG
-HistManager::HistManager(RootMergeFileManager *fm)
-        : time_ring( fm->CreateTH2("time_ring", "Time spectra rings", 3000, -1500, 1500, "Time [ns]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-        , time_sect( fm->CreateTH2("time_sect", "Time spectra sectors", 3000, -1500, 1500, "Time [ns]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-        , time_back( fm->CreateTH2("time_back", "Time spectra back detector", 3000, -1500, 1500, "Time [ns]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-        , time_labrL( fm->CreateTH2("time_labrL", "Time spectra LaBr L", 30000, -1500, 1500, "Time [ns]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-        , time_labrS( fm->CreateTH2("time_labrS", "Time spectra LaBr S", 3000, -1500, 1500, "Time [ns]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-        , time_labrF( fm->CreateTH2("time_labrF", "Time spectra LaBr F", 30000, -1500, 1500, "Time [ns]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-        , time_clover( fm->CreateTH2("time_clover", "Time spectra CLOVER", 3000, -1500, 1500, "Time [ns]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-        , time_energy_sect_back( fm->CreateTH2("time_energy_sect_back", "Energy vs. sector/back time", 1000, 0, 30000, "E energy [keV]", 3000, -1500, 1500, "t_{back} - t_{sector} [ns]") )
-        , time_energy_ring_sect( fm->CreateTH2("time_energy_ring_sect", "Energy vs. sector/back time", 1000, 0, 30000, "Sector energy [keV]", 3000, -1500, 1500, "t_{ring} - t_{sector} [ns]") )
-        , energy_ring( fm->CreateTH2("energy_ring", "Energy spectra rings", 16384, 0, 16384, "Energy [ch]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-        , energy_sect( fm->CreateTH2("energy_sect", "Energy spectra sectors", 16384, 0, 16384, "Energy [ch]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-        , energy_back( fm->CreateTH2("energy_back", "Energy spectra back detectors", 16384, 0, 16384, "Energy [ch]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-        , energy_labrL( fm->CreateTH2("energy_labrL", "Energy spectra LaBr L", 16384, 0, 16384, "Energy [ch]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-        , energy_labrS( fm->CreateTH2("energy_labrS", "Energy spectra LaBr S", 16384, 0, 16384, "Energy [ch]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-        , energy_labrF( fm->CreateTH2("energy_labrF", "Energy spectra LaBr F", 16384, 0, 16384, "Energy [ch]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-        , energy_clover( fm->CreateTH2("energy_clover", "Energy spectra CLOVER", 16384, 0, 16384, "Energy [ch]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-        , energy_cal_ring( fm->CreateTH2("energy_cal_ring", "Energy spectra rings", 16384, 0, 16384, "Energy [keV]", NUM_SI_RING, 0, NUM_SI_RING, "Ring ID") )
-        , energy_cal_sect( fm->CreateTH2("energy_cal_sect", "Energy spectra sectors", 16384, 0, 16384, "Energy [keV]", NUM_SI_SECT, 0, NUM_SI_SECT, "Sector ID") )
-        , energy_cal_back( fm->CreateTH2("energy_cal_back", "Energy spectra back detectors", 16384, 0, 16384, "Energy [keV]", NUM_SI_BACK, 0, NUM_SI_BACK, "Back ID") )
-        , energy_cal_labrL( fm->CreateTH2("energy_cal_labrL", "Energy spectra LaBr L", 16384, 0, 16384, "Energy [keV]", NUM_LABR_3X8_DETECTORS, 0, NUM_LABR_3X8_DETECTORS, "LaBr L ID") )
-        , energy_cal_labrS( fm->CreateTH2("energy_cal_labrS", "Energy spectra LaBr S", 16384, 0, 16384, "Energy [keV]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr S ID") )
-        , energy_cal_labrF( fm->CreateTH2("energy_cal_labrF", "Energy spectra LaBr F", 16384, 0, 16384, "Energy [keV]", NUM_LABR_2X2_DETECTORS, 0, NUM_LABR_2X2_DETECTORS, "LaBr F ID") )
-        , energy_cal_clover( fm->CreateTH2("energy_cal_clover", "Energy spectra CLOVER", 16384, 0, 16384, "Energy [keV]", NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, 0, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID") )
-        , addback_hist( fm->CreateTH2("time_self_clover", "Time spectra, clover self timing",3000, -1500, 1500, "Time [ns]",NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+HistManager::HistManager(RootMergeFileManager *fm, const std::vector<HistogramDefinition> &definitions)
+        : addback_hist( fm->CreateTH2("time_self_clover", "Time spectra, clover self timing",3000, -1500, 1500, "Time [ns]",NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+        , energy_addback_clover( fm->CreateTH2("energy_ab_clover", "Energy spectra CLOVER after addback", 16384, 0, 16384, "Energy [keV]", NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS, "Clover detector") )
+        , ede_particle( fm->CreateTH2("ede_particle", "dE-E spectrum of reconstructed particles", 1000, 0, 30000, "E energy [keV]", 1000, 0, 15000, "dE energy [keV]") )
 {
+    Setup(fm, definitions);
 }
 #endif // ROOT_MT_FLAG
 
-void HistManager::FillTDiff(const Event::iThembaEntry &start, const std::vector<Event::iThembaEntry> &entries, TH2 *hist)
+template<class FileManager>
+void HistManager::Setup(FileManager *fm, const std::vector<HistogramDefinition> &definitions)
 {
-    double tdiff;
-    for ( auto &stop : entries ){
-        tdiff = double(stop.tcoarse  - start.tcoarse);
-        tdiff += stop.tfine - start.tfine;
-        hist->Fill(tdiff, stop.ID);
-    }
-}
+    hists.reserve(definitions.size());
+    for ( auto &def : definitions ){
+        FillStep step = {def.axis, 0, def.gate_low, def.gate_high, hists.size()};
+        hists.emplace_back(fm->CreateTH2(def.name.c_str(), def.title.c_str(),
+                                         def.xbins, def.xmin, def.xmax, def.xtitle.c_str(),
+                                         def.ybins, 0, def.ybins, def.ytitle.c_str()));
 
-void HistManager::FillEnergy(const std::vector<Event::iThembaEntry> &entries, TH2 *hist, TH2 *hist_cal)
-{
-    for ( auto &entry : entries ){
-        hist->Fill(entry.e_raw, entry.ID);
-        hist_cal->Fill(entry.energy, entry.ID);
+        if ( def.axis == HistogramDefinition::axis_time ){
+            for ( step.reference = 0 ; step.reference < references.size() ; ++step.reference ){
+                const Reference &ref = references[step.reference];
+                if ( ref.type == def.reference && ( ref.type == rfchan || ref.ID == def.reference_id ) )
+                    break;
+            }
+            if ( step.reference == references.size() )
+                references.push_back({def.reference, def.reference_id, {}});
+        }
+
+        if ( plan[def.detector].empty() )
+            types.push_back(def.detector);
+        plan[def.detector].push_back(step);
     }
 }
 
-
 void HistManager::AddEntry(const Event::iThembaEvent &event)
 {
-    // First time spectra. We use the RF as reference.
-
+    // First find the times of the references of the time spectra.
+    for ( auto &ref : references ){
+        ref.times.clear();
+        const Event::EntryColumns *columns = event.GetColumns(ref.type);
+        for ( int i = 0 ; columns && i < columns->mult ; ++i ){
+            if ( ref.type == rfchan || columns->ID[i] == ref.ID )
+                ref.times.emplace_back(columns->tcoarse[i], columns->tfine[i]);
+        }
+    }
 
-    for ( auto &rfEntry : event.GetLabrF() ){
-        if ( rfEntry.ID != 0 )
+    for ( auto &type : types ){
+        const Event::EntryColumns *columns = event.GetColumns(type);
+        if ( !columns )
             continue;
+        const std::vector<FillStep> &steps = plan[type];
+        for ( int i = 0 ; i < columns->mult ; ++i ){
+            for ( auto &step : steps ){
+                if ( step.gate_high > step.gate_low &&
+                     ( columns->energy[i] < step.gate_low || columns->energy[i] > step.gate_high ) )
+                    continue;
 
-        FillTDiff(rfEntry, event.GetRing(), time_ring);
-        FillTDiff(rfEntry, event.GetSect(), time_sect);
-        FillTDiff(rfEntry, event.GetBack(), time_back);
-        FillTDiff(rfEntry, event.GetLabrL(), time_labrL);
-        FillTDiff(rfEntry, event.GetLabrS(), time_labrS);
-        FillTDiff(rfEntry, event.GetLabrF(), time_labrF);
-        FillTDiff(rfEntry, event.GetClover(), time_clover);
+                switch ( step.axis ){
+                    case HistogramDefinition::axis_e_raw :
+                        hists[step.hist].Fill(columns->e_raw[i], columns->ID[i]);
+                        break;
+                    case HistogramDefinition::axis_energy :
+                        hists[step.hist].Fill(columns->energy[i], columns->ID[i]);
+                        break;
+                    case HistogramDefinition::axis_time :
+                        for ( auto &start : references[step.reference].times ){
+                            double tdiff = double(columns->tcoarse[i] - start.first);
+                            tdiff += columns->tfine[i] - start.second;
+                            hists[step.hist].Fill(tdiff, columns->ID[i]);
+                        }
+                        break;
+                }
+            }
+        }
     }
 
-    FillEnergy(event.GetRing(), energy_ring, energy_cal_ring);
-    FillEnergy(event.GetSect(), energy_sect, energy_cal_sect);
-    FillEnergy(event.GetBack(), energy_back, energy_cal_back);
-    FillEnergy(event.GetLabrL(), energy_labrL, energy_cal_labrL);
-    FillEnergy(event.GetLabrS(), energy_labrS, energy_cal_labrS);
-    FillEnergy(event.GetLabrF(), energy_labrF, energy_cal_labrF);
-    FillEnergy(event.GetClover(), energy_clover, energy_cal_clover);
+    const Event::iThembaParticleData &particles = event.GetParticleData();
+    for ( int i = 0 ; i < particles.GetSize() ; ++i ){
+        ede_particle.Fill(particles.GetE(i), particles.GetdE(i));
+    }
 
 }
+
+void HistManager::AddAddback(const Event::iThembaEvent &event)
+{
+    const Event::EntryColumns &clover = event.GetCloverColumns();
+    for ( int i = 0 ; i < clover.mult ; ++i ){
+        energy_addback_clover.Fill(clover.energy[i], clover.ID[i]/NUM_CLOVER_CRYSTALS);
+    }
+}
+
+void HistManager::Flush()
+{
+    for ( auto &hist : hists )
+        hist.Flush();
+    energy_addback_clover.Flush();
+    ede_particle.Flush();
+}
@@ -0,0 +1,186 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/HistogramDefinition.h"
+
+#include <INIReader.h>
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+struct DetectorName_t {
+    const char *name;       //!< Name used in the definition file.
+    DetectorType type;      //!< Detector type.
+    int num;                //!< Number of detectors of the type.
+    const char *label;      //!< Label used in the default axis titles.
+};
+
+static const DetectorName_t detector_names[] = {
+    {"labr_3x8", labr_3x8, NUM_LABR_3X8_DETECTORS, "LaBr L ID"},
+    {"labr_2x2_ss", labr_2x2_ss, NUM_LABR_2X2_DETECTORS, "LaBr S ID"},
+    {"labr_2x2_fs", labr_2x2_fs, NUM_LABR_2X2_DETECTORS, "LaBr F ID"},
+    {"clover", clover, NUM_CLOVER_DETECTORS*NUM_CLOVER_CRYSTALS, "CLOVER ID"},
+    {"de_ring", de_ring, NUM_SI_RING, "Ring ID"},
+    {"de_sect", de_sect, NUM_SI_SECT, "Sector ID"},
+    {"eDet", eDet, NUM_SI_BACK, "Back ID"},
+    {"rfchan", rfchan, 1, "RF ID"}
+};
+
+static const DetectorName_t *FindDetector(const std::string &name)
+{
+    for ( auto &detector : detector_names ){
+        if ( name == detector.name )
+            return &detector;
+    }
+    return nullptr;
+}
+
+static const DetectorName_t *FindDetector(const DetectorType &type)
+{
+    for ( auto &detector : detector_names ){
+        if ( type == detector.type )
+            return &detector;
+    }
+    return nullptr;
+}
+
+static HistogramDefinition Define(const char *name, const char *title, const DetectorType &type,
+                                  const HistogramDefinition::Axis &axis, int xbins, double xmin, double xmax,
+                                  const char *xtitle)
+{
+    const DetectorName_t *detector = FindDetector(type);
+    return {name, title, type, axis, labr_2x2_fs, 0, 0, 0, xbins, xmin, xmax, xtitle, detector->num, detector->label};
+}
+
+std::vector<HistogramDefinition> DefaultHistograms()
+{
+    typedef HistogramDefinition HD;
+    return {
+        Define("time_ring", "Time spectra rings", de_ring, HD::axis_time, 3000, -1500, 1500, "Time [ns]"),
+        Define("time_sect", "Time spectra sectors", de_sect, HD::axis_time, 3000, -1500, 1500, "Time [ns]"),
+        Define("time_back", "Time spectra back detector", eDet, HD::axis_time, 3000, -1500, 1500, "Time [ns]"),
+        Define("time_labrL", "Time spectra LaBr L", labr_3x8, HD::axis_time, 30000, -1500, 1500, "Time [ns]"),
+        Define("time_labrS", "Time spectra LaBr S", labr_2x2_ss, HD::axis_time, 3000, -1500, 1500, "Time [ns]"),
+        Define("time_labrF", "Time spectra LaBr F", labr_2x2_fs, HD::axis_time, 30000, -1500, 1500, "Time [ns]"),
+        Define("time_clover", "Time spectra CLOVER", clover, HD::axis_time, 3000, -1500, 1500, "Time [ns]"),
+        Define("energy_ring", "Energy spectra rings", de_ring, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_sect", "Energy spectra sectors", de_sect, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_back", "Energy spectra back detectors", eDet, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_labrL", "Energy spectra LaBr L", labr_3x8, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_labrS", "Energy spectra LaBr S", labr_2x2_ss, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_labrF", "Energy spectra LaBr F", labr_2x2_fs, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_clover", "Energy spectra CLOVER", clover, HD::axis_e_raw, 16384, 0, 16384, "Energy [ch]"),
+        Define("energy_cal_ring", "Energy spectra rings", de_ring, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_sect", "Energy spectra sectors", de_sect, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_back", "Energy spectra back detectors", eDet, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_labrL", "Energy spectra LaBr L", labr_3x8, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_labrS", "Energy spectra LaBr S", labr_2x2_ss, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_labrF", "Energy spectra LaBr F", labr_2x2_fs, HD::axis_energy, 16384, 0, 16384, "Energy [keV]"),
+        Define("energy_cal_clover", "Energy spectra CLOVER", clover, HD::axis_energy, 16384, 0, 16384, "Energy [keV]")
+    };
+}
+
+//! Keys of a histogram section.
+static const char *histogram_keys[] = {
+    "title", "detector", "axis", "reference", "gate", "xbins", "xmin", "xmax", "xtitle", "ybins", "ytitle"
+};
+
+//! Layout of a definition file, the INIReader keeps neither the order of the sections nor the keys.
+struct FileLayout_t {
+    std::vector<std::string> sections;  //!< Sections in the order of the file.
+    std::string error;                  //!< Error of the first unknown key, empty if none.
+};
+
+static int LayoutHandler(void *user, const char *section, const char *name, const char *)
+{
+    auto *layout = static_cast<FileLayout_t *>(user);
+    if ( std::find(layout->sections.begin(), layout->sections.end(), section) == layout->sections.end() )
+        layout->sections.push_back(section);
+
+    // The keys are case-insensitive, as in the INIReader.
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    auto is_key = [&key](const char *known){ return key == known; };
+    if ( layout->error.empty() && std::none_of(std::begin(histogram_keys), std::end(histogram_keys), is_key) )
+        layout->error = "Histogram '" + std::string(section) + "': unknown key '" + name + "'";
+    return 1;
+}
+
+std::vector<HistogramDefinition> ReadHistograms(const char *filename)
+{
+    INIReader reader(filename);
+    if ( reader.ParseError() < 0 )
+        throw std::runtime_error("Unable to open histogram definitions '" + std::string(filename) + "'");
+    if ( reader.ParseError() > 0 )
+        throw std::runtime_error("Error on line " + std::to_string(reader.ParseError()) +
+                                 " of histogram definitions '" + std::string(filename) + "'");
+
+    // The spectra are made in the order of the file, and misspelled keys are not silently ignored.
+    FileLayout_t layout;
+    ini_parse(filename, LayoutHandler, &layout);
+    if ( !layout.error.empty() )
+        throw std::runtime_error(layout.error);
+
+    std::vector<HistogramDefinition> definitions;
+    for ( auto &section : layout.sections ){
+        const std::string error = "Histogram '" + section + "': ";
+
+        const DetectorName_t *detector = FindDetector(reader.Get(section, "detector", ""));
+        if ( !detector )
+            throw std::runtime_error(error + "unknown detector '" + reader.Get(section, "detector", "") + "'");
+
+        if ( detector->type == rfchan )
+            throw std::runtime_error(error + "the RF can only be used as a time reference");
+
+        HistogramDefinition def = Define(section.c_str(), reader.Get(section, "title", section).c_str(),
+                                         detector->type, HistogramDefinition::axis_energy, 0, 0, 0, "");
+
+        std::string axis = reader.Get(section, "axis", "energy");
+        if ( axis == "e_raw" ){
+            def.axis = HistogramDefinition::axis_e_raw;
+            def.xtitle = "Energy [ch]";
+        } else if ( axis == "energy" ){
+            def.axis = HistogramDefinition::axis_energy;
+            def.xtitle = "Energy [keV]";
+        } else if ( axis == "time" ){
+            def.axis = HistogramDefinition::axis_time;
+            def.xtitle = "Time [ns]";
+        } else {
+            throw std::runtime_error(error + "unknown axis '" + axis + "'");
+        }
+
+        std::string reference = reader.Get(section, "reference", "");
+        if ( !reference.empty() ){
+            std::istringstream is(reference);
+            std::string ref_name;
+            if ( !(is >> ref_name >> def.reference_id) )
+                throw std::runtime_error(error + "reference must be a detector and an ID");
+            const DetectorName_t *ref = FindDetector(ref_name);
+            if ( !ref )
+                throw std::runtime_error(error + "unknown reference detector '" + ref_name + "'");
+            def.reference = ref->type;
+        }
+
+        std::string gate = reader.Get(section, "gate", "");
+        if ( !gate.empty() ){
+            std::istringstream is(gate);
+            if ( !(is >> def.gate_low >> def.gate_high) || def.gate_high <= def.gate_low )
+                throw std::runtime_error(error + "gate must be a lower and a higher energy");
+        }
+
+        def.xbins = int(reader.GetInteger(section, "xbins", 0));
+        def.xmin = reader.GetReal(section, "xmin", 0);
+        def.xmax = reader.GetReal(section, "xmax", 0);
+        def.xtitle = reader.Get(section, "xtitle", def.xtitle);
+        def.ybins = int(reader.GetInteger(section, "ybins", def.ybins));
+        def.ytitle = reader.Get(section, "ytitle", def.ytitle);
+        if ( def.xbins <= 0 || def.xmax <= def.xmin || def.ybins <= 0 )
+            throw std::runtime_error(error + "invalid binning");
+
+        definitions.push_back(def);
+    }
+    return definitions;
+}
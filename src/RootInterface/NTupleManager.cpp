@@ -0,0 +1,227 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/NTupleManager.h"
+
+#include <stdexcept>
+
+#if ROOT_NTUPLE_FLAG
+
+#include <Event/iThembaEvent.h>
+#include <Parameters/experimentsetup.h>
+
+#include <RVersion.h>
+#include <ROOT/REntry.hxx>
+#include <ROOT/RNTupleFillContext.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleParallelWriter.hxx>
+#include <ROOT/RNTupleWriteOptions.hxx>
+
+#include <string>
+#include <vector>
+
+// The RNTuple classes left the experimental namespace in ROOT 6.36.
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,36,0)
+using ROOT::REntry;
+using ROOT::RNTupleFillContext;
+using ROOT::RNTupleModel;
+using ROOT::RNTupleParallelWriter;
+using ROOT::RNTupleWriteOptions;
+#else
+using ROOT::Experimental::REntry;
+using ROOT::Experimental::RNTupleFillContext;
+using ROOT::Experimental::RNTupleModel;
+using ROOT::Experimental::RNTupleParallelWriter;
+using ROOT::RNTupleWriteOptions;
+#endif // ROOT_VERSION_CODE
+
+struct Component_t {
+    const char *name;       //!< Base name of the fields.
+    DetectorType type;      //!< Detector type stored.
+    bool time_only;         //!< Only the time is stored.
+};
+
+static const Component_t components[] = {
+    {"ring", de_ring, false},
+    {"sector", de_sect, false},
+    {"back", eDet, false},
+    {"labrL", labr_3x8, false},
+    {"labrS", labr_2x2_ss, false},
+    {"labrF", labr_2x2_fs, false},
+    {"clover", clover, false},
+    {"rf", rfchan, true}
+};
+
+struct NTupleWriter::Impl {
+    std::unique_ptr<RNTupleParallelWriter> writer;
+    bool particles;
+};
+
+NTupleWriter::NTupleWriter(const char *fname, const char *name, const RootOutputOptions &options, const bool &particles)
+    : impl( new Impl )
+{
+    impl->particles = particles;
+    auto model = RNTupleModel::Create();
+    for ( auto &component : components ){
+        const std::string base = component.name;
+        if ( !component.time_only ){
+            model->MakeField<std::vector<uint16_t> >(base + "ID");
+            model->MakeField<std::vector<uint16_t> >(base + "_e_raw");
+            model->MakeField<std::vector<double> >(base + "Energy");
+        }
+        model->MakeField<std::vector<double> >(base + "Tfine");
+        model->MakeField<std::vector<int64_t> >(base + "Tcoarse");
+        model->MakeField<std::vector<bool> >(base + "CFDvalid");
+    }
+    if ( particles ){
+        model->MakeField<std::vector<int16_t> >("particleTelescope");
+        model->MakeField<std::vector<uint16_t> >("particleRing");
+        model->MakeField<std::vector<int16_t> >("particleSect");
+        model->MakeField<std::vector<uint16_t> >("particleBack");
+        model->MakeField<std::vector<double> >("particle_dE");
+        model->MakeField<std::vector<double> >("particle_E");
+        model->MakeField<std::vector<double> >("particleTheta");
+        model->MakeField<std::vector<double> >("particleTfine");
+        model->MakeField<std::vector<int64_t> >("particleTcoarse");
+    }
+
+    RNTupleWriteOptions writeOptions;
+    if ( options.compression >= 0 )
+        writeOptions.SetCompression(options.compression);
+    impl->writer = RNTupleParallelWriter::Recreate(std::move(model), name, fname, writeOptions);
+}
+
+NTupleWriter::~NTupleWriter() = default;
+
+struct NTupleManager::Impl {
+
+    //! Fields of a detector type.
+    struct Fields_t {
+        DetectorType type;
+        std::shared_ptr<std::vector<uint16_t> > ID;
+        std::shared_ptr<std::vector<uint16_t> > e_raw;
+        std::shared_ptr<std::vector<double> > energy;
+        std::shared_ptr<std::vector<double> > tfine;
+        std::shared_ptr<std::vector<int64_t> > tcoarse;
+        std::shared_ptr<std::vector<bool> > cfdvalid;
+    };
+
+    std::shared_ptr<RNTupleFillContext> context;
+    std::unique_ptr<REntry> entry;
+    std::vector<Fields_t> fields;
+
+    std::shared_ptr<std::vector<int16_t> > telescope;
+    std::shared_ptr<std::vector<uint16_t> > ring;
+    std::shared_ptr<std::vector<int16_t> > sect;
+    std::shared_ptr<std::vector<uint16_t> > back;
+    std::shared_ptr<std::vector<double> > dE;
+    std::shared_ptr<std::vector<double> > E;
+    std::shared_ptr<std::vector<double> > theta;
+    std::shared_ptr<std::vector<double> > tfine;
+    std::shared_ptr<std::vector<int64_t> > tcoarse;
+};
+
+NTupleManager::NTupleManager(NTupleWriter *writer)
+    : impl( new Impl )
+{
+    impl->context = writer->impl->writer->CreateFillContext();
+    impl->entry = impl->context->CreateEntry();
+    REntry &entry = *impl->entry;
+    for ( auto &component : components ){
+        const std::string base = component.name;
+        Impl::Fields_t fields;
+        fields.type = component.type;
+        if ( !component.time_only ){
+            fields.ID = entry.GetPtr<std::vector<uint16_t> >(base + "ID");
+            fields.e_raw = entry.GetPtr<std::vector<uint16_t> >(base + "_e_raw");
+            fields.energy = entry.GetPtr<std::vector<double> >(base + "Energy");
+        }
+        fields.tfine = entry.GetPtr<std::vector<double> >(base + "Tfine");
+        fields.tcoarse = entry.GetPtr<std::vector<int64_t> >(base + "Tcoarse");
+        fields.cfdvalid = entry.GetPtr<std::vector<bool> >(base + "CFDvalid");
+        impl->fields.push_back(fields);
+    }
+    if ( !writer->impl->particles )
+        return;
+    impl->telescope = entry.GetPtr<std::vector<int16_t> >("particleTelescope");
+    impl->ring = entry.GetPtr<std::vector<uint16_t> >("particleRing");
+    impl->sect = entry.GetPtr<std::vector<int16_t> >("particleSect");
+    impl->back = entry.GetPtr<std::vector<uint16_t> >("particleBack");
+    impl->dE = entry.GetPtr<std::vector<double> >("particle_dE");
+    impl->E = entry.GetPtr<std::vector<double> >("particle_E");
+    impl->theta = entry.GetPtr<std::vector<double> >("particleTheta");
+    impl->tfine = entry.GetPtr<std::vector<double> >("particleTfine");
+    impl->tcoarse = entry.GetPtr<std::vector<int64_t> >("particleTcoarse");
+}
+
+NTupleManager::~NTupleManager() = default;
+
+void NTupleManager::AddEntry(const Event::iThembaEvent &event)
+{
+    for ( auto &fields : impl->fields ){
+        const Event::EntryColumns &columns = *event.GetColumns(fields.type);
+        const int mult = columns.mult;
+        if ( fields.ID ){
+            fields.ID->assign(columns.ID, columns.ID + mult);
+            fields.e_raw->assign(columns.e_raw, columns.e_raw + mult);
+            fields.energy->assign(columns.energy, columns.energy + mult);
+        }
+        fields.tfine->assign(columns.tfine, columns.tfine + mult);
+        fields.tcoarse->assign(columns.tcoarse, columns.tcoarse + mult);
+        fields.cfdvalid->assign(columns.cfdvalid, columns.cfdvalid + mult);
+    }
+
+    // The particle fields only exist if the particles are reconstructed.
+    if ( impl->telescope ){
+        const Event::iThembaParticleData &particles = event.GetParticleData();
+        impl->telescope->clear();
+        impl->ring->clear();
+        impl->sect->clear();
+        impl->back->clear();
+        impl->dE->clear();
+        impl->E->clear();
+        impl->theta->clear();
+        impl->tfine->clear();
+        impl->tcoarse->clear();
+        for ( int i = 0 ; i < particles.GetSize() ; ++i ){
+            const Event::iThembaParticle particle = particles[i];
+            impl->telescope->push_back(particle.telescope);
+            impl->ring->push_back(particle.ring);
+            impl->sect->push_back(particle.sect);
+            impl->back->push_back(particle.back);
+            impl->dE->push_back(particle.dE);
+            impl->E->push_back(particle.E);
+            impl->theta->push_back(particle.theta);
+            impl->tfine->push_back(particle.tfine);
+            impl->tcoarse->push_back(particle.tcoarse);
+        }
+    }
+
+    impl->context->Fill(*impl->entry);
+}
+
+#else
+
+struct NTupleWriter::Impl {};
+struct NTupleManager::Impl {};
+
+NTupleWriter::NTupleWriter(const char *, const char *, const RootOutputOptions &, const bool &)
+{
+    throw std::runtime_error("Built without RNTuple support, configure with ENABLE_RNTUPLE");
+}
+
+NTupleWriter::~NTupleWriter() = default;
+
+NTupleManager::NTupleManager(NTupleWriter *)
+{
+    throw std::runtime_error("Built without RNTuple support, configure with ENABLE_RNTUPLE");
+}
+
+NTupleManager::~NTupleManager() = default;
+
+void NTupleManager::AddEntry(const Event::iThembaEvent &)
+{
+}
+
+#endif // ROOT_NTUPLE_FLAG
@@ -26,10 +26,13 @@
 #include <ROOT/TBufferMerger.hxx>
 
 
-RootFileManager::RootFileManager(const char *fname, const char *mode, const char *ftitle)
+RootFileManager::RootFileManager(const char *fname, const char *mode, const char *ftitle, const RootOutputOptions &opt)
     : file( fname, mode, ftitle )
+    , options( opt )
 {
     //list.SetOwner(false);
+    if ( options.compression >= 0 )
+        file.SetCompressionSettings(options.compression);
 }
 
 RootFileManager::~RootFileManager()
@@ -38,9 +41,21 @@ RootFileManager::~RootFileManager()
     file.Close();
 }
 
+//! Apply the tree settings of the output options.
+static void SetupTree(TTree *tree, const RootOutputOptions &options)
+{
+    if ( options.autoflush != 0 )
+        tree->SetAutoFlush(options.autoflush);
+    if ( options.autosave != 0 )
+        tree->SetAutoSave(options.autosave);
+}
+
 TTree *RootFileManager::CreateTree(const char *name, const char *title)
 {
+    // Several files may be open, the tree has to be attached to this one.
+    file.cd();
     auto *tree = new TTree( ( name != nullptr ) ? name : "tree", ( title != nullptr ) ? title : "" );
+    SetupTree(tree, options);
     if ( name != nullptr )
         list.push_back(tree);
     return tree;
@@ -84,17 +99,32 @@ TH2 *RootFileManager::CreateTH2(const char *name, const char *title, int xbin, d
 }
 
 #if ROOT_MT_FLAG
-RootMergeFileManager::RootMergeFileManager(ROOT::Experimental::TBufferMerger *bm)
-        : file( bm->GetFile() ){}
+RootMergeFileManager::RootMergeFileManager(ROOT::Experimental::TBufferMerger *bm, const RootOutputOptions &opt)
+        : file( bm->GetFile() )
+        , options( opt ){}
 
 RootMergeFileManager::~RootMergeFileManager()
 {
     file->Write();
 }
 
+void RootMergeFileManager::Write()
+{
+    // The trees are emptied by the merger, the histograms has to be reset here
+    // to avoid that the same counts are merged more than once.
+    file->Write();
+    for ( auto *obj : list ){
+        if ( obj->InheritsFrom(TH1::Class()) )
+            reinterpret_cast<TH1 *>(obj)->Reset();
+    }
+}
+
 TTree *RootMergeFileManager::CreateTree(const char *name, const char *title)
 {
+    // The tree has to be attached to the merger file, not the current directory of the thread.
+    file->cd();
     auto *tree = new TTree( ( name != nullptr ) ? name : "tree", ( title != nullptr ) ? title : "" );
+    SetupTree(tree, options);
     if ( name != nullptr )
         list.push_back(tree);
     return tree;
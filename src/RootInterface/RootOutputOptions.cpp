@@ -0,0 +1,45 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/RootOutputOptions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+struct CompressionName_t {
+    const char *name;       //!< Name of the algorithm.
+    int algorithm;          //!< ROOT algorithm number (ROOT::ECompressionAlgorithm).
+    int level;              //!< Default level of the algorithm.
+};
+
+static const CompressionName_t compression_names[] = {
+    {"zlib", 1, 1},
+    {"lzma", 2, 7},
+    {"lz4", 4, 4},
+    {"zstd", 5, 5}
+};
+
+int ParseCompression(const std::string &text)
+{
+    std::string name = text.substr(0, text.find(':'));
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c){ return std::tolower(c); });
+
+    if ( name == "none" )
+        return 0;
+
+    for ( auto &compression : compression_names ){
+        if ( name != compression.name )
+            continue;
+        int level = compression.level;
+        if ( name.size() < text.size() ){
+            const std::string level_str = text.substr(name.size() + 1);
+            if ( level_str.size() != 1 || level_str[0] < '1' || level_str[0] > '9' )
+                throw std::invalid_argument("Invalid compression level '" + level_str + "'");
+            level = level_str[0] - '0';
+        }
+        return 100*compression.algorithm + level;
+    }
+    throw std::invalid_argument("Unknown compression algorithm '" + name + "'");
+}
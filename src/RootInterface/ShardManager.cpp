@@ -0,0 +1,50 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "RootInterface/ShardManager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+ShardManager::ShardManager(const char *fname, const RootOutputOptions &opt, const ShardLimits &lim)
+    : base( fname )
+    , options( opt )
+    , limits( lim )
+{
+    const std::string suffix = ".root";
+    if ( base.size() > suffix.size() && base.compare(base.size() - suffix.size(), suffix.size(), suffix) == 0 )
+        base.resize(base.size() - suffix.size());
+}
+
+ShardManager::~ShardManager()
+{
+    file.reset();
+    if ( shards.empty() )
+        return;
+
+    const std::string manifest = base + "_shards.txt";
+    std::ofstream output(manifest);
+    if ( !output ){
+        std::cerr << "Warning: Unable to write shard manifest '" << manifest << "'" << std::endl;
+        return;
+    }
+    output << "# file\tentries\tbytes\tfirst_time [ns]\tlast_time [ns]\n";
+    for ( auto &shard : shards ){
+        output << shard.name << "\t" << shard.entries << "\t" << shard.bytes << "\t";
+        output << shard.first_time << "\t" << shard.last_time << "\n";
+    }
+}
+
+RootFileManager *ShardManager::Next()
+{
+    // The current shard is written and closed before the next is opened.
+    file.reset();
+
+    char name[1024];
+    snprintf(name, sizeof(name), "%s_shard%04zu.root", base.c_str(), shards.size());
+    shards.push_back({name, 0, 0, 0, 0});
+    file.reset(new RootFileManager(name, "RECREATE", "", options));
+    return file.get();
+}
@@ -3,3 +3,13 @@
 //
 
 #include "RootInterface/TreeManager.h"
+
+void TreeManager::NextShard()
+{
+    RootFileManager *fm = shards->Next();
+    tree = fm->CreateTree(name.c_str(), title.c_str());
+    entry_obj->SetStorage(fm->GetOptions().storage);
+    entry_obj->SetupTree(tree, types);
+    if ( fm->GetOptions().basket_size > 0 )
+        tree->SetBasketSize("*", fm->GetOptions().basket_size);
+}
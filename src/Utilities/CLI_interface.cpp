@@ -12,6 +12,7 @@ Settings_t::~Settings_t()
     delete buffer_type;
     delete parser;
     delete event_type;
+    delete condition;
 
     delete input_queue;
     delete split_queue;
@@ -2,125 +2,129 @@
 // Created by Vetle Wegner Ingeberg on 01/10/2020.
 //
 
-#include <map>
 #include <string>
-#include <exception>
-
-#include <cerrno>
+#include <stdexcept>
 
 #include "Utilities/HDF5_writer.h"
 
 #include <spdlog/spdlog.h>
 
-#include <unistd.h>
-#include <sys/fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-
 #include <Parameters/experimentsetup.h>
 
-const std::map<std::string, hid_t> entry_map =
-        {{"dtype", H5T_NATIVE_UINT16},
-         {"id", H5T_NATIVE_UINT16},
-         {"adcdata", H5T_NATIVE_UINT16},
-         {"cfddata", H5T_NATIVE_UINT16},
-         {"timestamp", H5T_NATIVE_INT64},
-         {"cfdcorr", H5T_IEEE_F64LE},
-         {"energy", H5T_IEEE_F64LE},
-         {"cfdfail", H5T_NATIVE_HBOOL},
-         {"finishcode", H5T_NATIVE_HBOOL}
-        };
-
-haddr_t Create_column(hid_t &group, const char *column_name, hid_t type, int no_rows, int i)
+HDF5_Writer::HDF5_Writer(const char *fname)
+    : file( H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT) )
+    , group( -1 )
+    , columns( {{"dtype", H5T_NATIVE_UINT16, H5T_NATIVE_UINT16, -1},
+                {"id", H5T_NATIVE_INT16, H5T_NATIVE_INT16, -1},
+                {"adcdata", H5T_NATIVE_UINT16, H5T_NATIVE_UINT16, -1},
+                {"cfddata", H5T_NATIVE_UINT16, H5T_NATIVE_UINT16, -1},
+                {"timestamp", H5T_NATIVE_INT64, H5T_NATIVE_INT64, -1},
+                {"cfdcorr", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, -1},
+                {"energy", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, -1},
+                {"cfdfail", H5T_NATIVE_HBOOL, H5T_NATIVE_UINT8, -1},
+                {"finishcode", H5T_NATIVE_HBOOL, H5T_NATIVE_UINT8, -1}} )
+    , rows( 0 )
 {
-    hsize_t dims[1];
-    herr_t status;
-    dims[0] = no_rows;
-    hid_t space = H5Screate_simple(1, dims, NULL);
-    hid_t dcpl = H5Pcreate (H5P_DATASET_CREATE);
-    H5Pset_layout (dcpl, H5D_CONTIGUOUS); // compact allows us the memory map the file
-    H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY); // need this to allocate the space so offset exists
-    hid_t dset = H5Dcreate(group, column_name, type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-
-    haddr_t offset = H5Dget_offset(dset);
-    H5D_space_status_t space_status;
-    H5Dget_space_status(dset, &space_status);
-
-    spdlog::info("offset[{:d}] = {:x} allocated: {}\n", i, (unsigned int)offset,
-                         (space_status == H5D_SPACE_STATUS_ALLOCATED ? "yes" : "no"));
-
-    status = H5Dclose (dset);
-    status = H5Pclose (dcpl);
-    status = H5Sclose (space);
-
-    return offset;
+    if ( file < 0 )
+        throw std::runtime_error(std::string("Unable to create '") + fname + "'");
+    group = H5Gcreate(file, "data", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    // The datasets start empty and are extended by whole chunks as the entries are written.
+    hsize_t dims[1] = {0};
+    hsize_t maxdims[1] = {H5S_UNLIMITED};
+    hsize_t chunk[1] = {chunk_rows};
+    hid_t space = H5Screate_simple(1, dims, maxdims);
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 1, chunk);
+    for ( auto &column : columns ){
+        column.dset = H5Dcreate(group, column.name, column.file_type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        if ( column.dset < 0 ){
+            H5Pclose(dcpl);
+            H5Sclose(space);
+            throw std::runtime_error(std::string("Unable to create dataset '") + column.name + "'");
+        }
+    }
+    H5Pclose(dcpl);
+    H5Sclose(space);
+
+    dtype.reserve(chunk_rows);
+    id.reserve(chunk_rows);
+    adcdata.reserve(chunk_rows);
+    cfddata.reserve(chunk_rows);
+    timestamp.reserve(chunk_rows);
+    cfdcorr.reserve(chunk_rows);
+    energy.reserve(chunk_rows);
+    cfdfail.reserve(chunk_rows);
+    finishcode.reserve(chunk_rows);
 }
 
-void HDF5_Writer::allocate(const char *fname, const int &rows)
+HDF5_Writer::~HDF5_Writer()
 {
-    noRows = rows;
-    hid_t file;    /* Handles */
-    herr_t status;
-    haddr_t	offsets[MAX_COLUMNS];
-    hsize_t dims[1];
-
-    file = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-    hid_t group = H5Gcreate1(file, "data", 0);
-
-    // Since this is C++ and there are no such thing as reflection we will do this manually.
-    int i = 0;
-    for (auto &column : entry_map){
-        offsets[i] = Create_column(group, column.first.c_str(), column.second, noRows, i);
-        ++i;
+    try {
+        Flush();
+    } catch ( const std::runtime_error &e ){
+        spdlog::error("{}", e.what());
     }
-
-    H5Gclose(group);
-    status = H5Fclose(file);
-
-    struct stat s{};
-    status = stat(fname, &s);
-    if ( status < 0 )
-        throw std::runtime_error(std::string("stat ") + fname + " failed: " + strerror(errno));
-    spdlog::info("File size {}", (unsigned long long)s.st_size);
-
-    fd = open(fname, O_RDWR);
-    if ( fd < 0 )
-        throw std::runtime_error(std::string("open ") + fname + " failed: " + strerror(errno));
-
-    char *mapped = (char *)mmap(NULL, s.st_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
-    if ( mapped == MAP_FAILED )
-        throw std::runtime_error(std::string("mmap ") + fname + " failed: " + strerror(errno));
-
-    points.setup(mapped, offsets);
+    for ( auto &column : columns ){
+        if ( column.dset >= 0 )
+            H5Dclose(column.dset);
+    }
+    if ( group >= 0 )
+        H5Gclose(group);
+    if ( file >= 0 )
+        H5Fclose(file);
 }
 
-HDF5_Writer::HDF5_Writer(const char *fname, const int &rows) : noRows( 0 ), row_idx( 0 ), fd( 0 )
+void HDF5_Writer::Flush()
 {
-    allocate(fname, rows);
+    if ( dtype.empty() )
+        return;
+
+    const void *data[] = {dtype.data(), id.data(), adcdata.data(), cfddata.data(), timestamp.data(),
+                          cfdcorr.data(), energy.data(), cfdfail.data(), finishcode.data()};
+    hsize_t start[1] = {rows};
+    hsize_t count[1] = {dtype.size()};
+    hsize_t size[1] = {rows + dtype.size()};
+    hid_t mem_space = H5Screate_simple(1, count, nullptr);
+    for ( size_t i = 0 ; i < columns.size() ; ++i ){
+        H5Dset_extent(columns[i].dset, size);
+        hid_t file_space = H5Dget_space(columns[i].dset);
+        H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, nullptr, count, nullptr);
+        const herr_t status = H5Dwrite(columns[i].dset, columns[i].mem_type, mem_space, file_space, H5P_DEFAULT, data[i]);
+        H5Sclose(file_space);
+        if ( status < 0 ){
+            H5Sclose(mem_space);
+            throw std::runtime_error(std::string("Unable to write dataset '") + columns[i].name + "'");
+        }
+    }
+    H5Sclose(mem_space);
+    rows += dtype.size();
+
+    dtype.clear();
+    id.clear();
+    adcdata.clear();
+    cfddata.clear();
+    timestamp.clear();
+    cfdcorr.clear();
+    energy.clear();
+    cfdfail.clear();
+    finishcode.clear();
 }
 
-HDF5_Writer::~HDF5_Writer()
+void HDF5_Writer::Write(const Parser::Entry_t *entries, const size_t &size)
 {
-    points.reset();
-    close(fd);
+    for ( size_t n = 0 ; n < size ; ++n ){
+        const Parser::Entry_t &entry = entries[n];
+        dtype.push_back(GetDetectorType(entry.address));
+        id.push_back(GetFlatID(entry.address));
+        adcdata.push_back(entry.adcdata);
+        cfddata.push_back(entry.cfddata);
+        timestamp.push_back(entry.timestamp);
+        cfdcorr.push_back(entry.cfdcorr);
+        energy.push_back(entry.energy);
+        cfdfail.push_back(entry.cfdfail);
+        finishcode.push_back(entry.finishcode);
+        if ( dtype.size() == chunk_rows )
+            Flush();
+    }
 }
-
-bool HDF5_Writer::Write(const Parser::Entry_t &entry)
-{
-    if (row_idx >= noRows)
-        return false;
-    auto dinfo = GetDetector(entry.address);
-    points.dtype[row_idx] = dinfo.type;
-    if (dinfo.type == clover)
-        points.id[row_idx] = NUM_CLOVER_DETECTORS*dinfo.detectorNum+dinfo.telNum;
-    else
-        points.id[row_idx] = dinfo.detectorNum;
-    points.adcdata[row_idx] = entry.adcdata;
-    points.cfddata[row_idx] = entry.cfddata;
-    points.timestamp[row_idx] = entry.timestamp;
-    points.cfdcorr[row_idx] = entry.cfdcorr;
-    points.energy[row_idx] = entry.energy;
-    points.cfdfail[row_idx] = entry.cfdfail;
-    points.finishcode[row_idx++] = entry.finishcode;
-    return true;
-}
\ No newline at end of file
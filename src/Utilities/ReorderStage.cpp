@@ -0,0 +1,67 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include "Utilities/ReorderStage.h"
+
+#include <utility>
+
+ReorderStage::ReorderStage(Chunk_queue_t *output_queue, const size_t &max_chunks)
+    : output( output_queue )
+    , max_pending( ( max_chunks > 0 ) ? max_chunks : 1 )
+    , next( 0 )
+    , aborted( false )
+{
+}
+
+bool ReorderStage::Push(Event::EventChunk &&chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t sequence = chunk.sequence;
+    forwarded.wait(lock, [this, sequence](){ return aborted || sequence < next + max_pending; });
+
+    if ( aborted )
+        return false;
+
+    if ( sequence != next ){
+        pending.emplace(sequence, std::move(chunk));
+        return true;
+    }
+
+    if ( !chunk.events.empty() )
+        output->enqueue(std::move(chunk));
+    ++next;
+
+    // Forward any chunks that were waiting for this one.
+    auto it = pending.begin();
+    while ( it != pending.end() && it->first == next ){
+        if ( !it->second.events.empty() )
+            output->enqueue(std::move(it->second));
+        it = pending.erase(it);
+        ++next;
+    }
+    lock.unlock();
+    forwarded.notify_all();
+    return true;
+}
+
+void ReorderStage::Abort()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    aborted = true;
+    pending.clear();
+    lock.unlock();
+    forwarded.notify_all();
+}
+
+bool ReorderStage::Aborted()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return aborted;
+}
+
+size_t ReorderStage::Pending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
@@ -0,0 +1,103 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Event/Addback.h>
+#include <Parameters/experimentsetup.h>
+
+#include "TestParameters.h"
+
+#include <doctest/doctest.h>
+
+#include <TH2.h>
+
+using namespace Event;
+
+//! Add a hit to the clover columns.
+static void AddHit(EntryColumns &clover, const int &crystal, const int64_t &time, const double &energy)
+{
+    const int n = clover.Next();
+    clover.ID[n] = uint16_t(crystal);
+    clover.e_raw[n] = uint16_t(energy);
+    clover.energy[n] = energy;
+    clover.tfine[n] = 0;
+    clover.tcoarse[n] = time;
+    clover.cfdvalid[n] = true;
+}
+
+TEST_CASE("Hits within the gate are merged")
+{
+    CalibrationBackup backup({"clover_addback_gate"});
+    REQUIRE(LoadCalibration("clover_addback_gate = -10 10"));
+
+    EntryColumns clover, scratch;
+    AddHit(clover, 1, 1005, 300);
+    AddHit(clover, 0, 1000, 500);
+    AddHit(clover, 2, 1100, 200);
+    AddHit(clover, NUM_CLOVER_CRYSTALS, 1000, 100);
+    Addback(clover, scratch, nullptr);
+
+    REQUIRE(clover.mult == 3);
+    CHECK(clover.ID[0] == 0);
+    CHECK(clover.energy[0] == 800);
+    CHECK(clover.tcoarse[0] == 1000);
+    CHECK(clover.e_raw[0] == 0);
+    CHECK(clover.ID[1] == 2);
+    CHECK(clover.energy[1] == 200);
+    CHECK(clover.tcoarse[1] == 1100);
+    CHECK(clover.ID[2] == NUM_CLOVER_CRYSTALS);
+    CHECK(clover.energy[2] == 100);
+}
+
+TEST_CASE("Nothing is merged with the default gate")
+{
+    EntryColumns clover, scratch;
+    AddHit(clover, 0, 1000, 500);
+    AddHit(clover, 1, 1005, 300);
+    Addback(clover, scratch, nullptr);
+    CHECK(clover.mult == 2);
+
+    clover.mult = 0;
+    Addback(clover, scratch, nullptr);
+    CHECK(clover.mult == 0);
+}
+
+TEST_CASE("Hits beyond the max. number in a clover are kept as they are")
+{
+    CalibrationBackup backup({"clover_addback_gate"});
+    REQUIRE(LoadCalibration("clover_addback_gate = -10 10"));
+
+    const int hits = MAX_ADDBACK_HITS + 4;
+    EntryColumns clover, scratch;
+    double merged = 0;
+    for ( int i = 0 ; i < hits ; ++i ){
+        AddHit(clover, i % NUM_CLOVER_CRYSTALS, 1000 + i % 3, 10.*(i + 1));
+        if ( i < MAX_ADDBACK_HITS )
+            merged += 10.*(i + 1);
+    }
+    Addback(clover, scratch, nullptr);
+
+    REQUIRE(clover.mult == hits - MAX_ADDBACK_HITS + 1);
+    for ( int i = 0 ; i < hits - MAX_ADDBACK_HITS ; ++i ){
+        CHECK(clover.energy[i] == 10.*(MAX_ADDBACK_HITS + i + 1));
+        CHECK(clover.e_raw[i] == uint16_t(clover.energy[i]));
+    }
+    CHECK(clover.energy[hits - MAX_ADDBACK_HITS] == merged);
+    CHECK(clover.e_raw[hits - MAX_ADDBACK_HITS] == 0);
+}
+
+TEST_CASE("Time differences are filled once for each hit")
+{
+    TH2D ab_t_clover("ab_t_clover", "ab_t_clover", 100, -50, 50, NUM_CLOVER_DETECTORS, 0, NUM_CLOVER_DETECTORS);
+    EntryColumns clover, scratch;
+    AddHit(clover, 0, 1000, 500);
+    AddHit(clover, 1, 1005, 300);
+    AddHit(clover, 2, 1020, 200);
+    AddHit(clover, 3, 1040, 100);
+    AddHit(clover, NUM_CLOVER_CRYSTALS, 1000, 100);
+
+    // With the default gate no hits are merged, hence every hit is a seed.
+    Addback(clover, scratch, &ab_t_clover);
+    CHECK(clover.mult == 5);
+    CHECK(ab_t_clover.GetEntries() == 3);
+}
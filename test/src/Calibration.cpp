@@ -0,0 +1,100 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Parameters/Calibration.h>
+
+#include "TestEntries.h"
+#include "TestParameters.h"
+
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+//! Calibrate the energy of a single entry with a given raw energy.
+static double Energy(const DetectorType &type, const int &num, const uint16_t &adcdata)
+{
+    Parser::Entry_t entry = MakeEntry(type, num, 0);
+    entry.adcdata = adcdata;
+    CalibrateEnergy(&entry, 1);
+    return entry.energy;
+}
+
+//! Calibrate the time of a single entry with a given raw energy.
+static double Time(const DetectorType &type, const int &num, const uint16_t &adcdata)
+{
+    Parser::Entry_t entry = MakeEntry(type, num, 0);
+    entry.adcdata = adcdata;
+    entry.cfddata = 0x2000;
+    return CalibrateTime(entry).cfdcorr;
+}
+
+TEST_CASE("Linear energy calibration")
+{
+    CalibrationBackup backup({"gain_labrL", "shift_labrL"});
+    REQUIRE(LoadCalibration("gain_labrL = 2 3 1 1 1 1\nshift_labrL = 5 -10 0 0 0 0"));
+
+    // The raw energy is dithered by up to half a channel.
+    for ( int n = 0 ; n < 100 ; ++n ){
+        CHECK(std::abs(Energy(labr_3x8, 0, 100) - 205) <= 1);
+        CHECK(std::abs(Energy(labr_3x8, 1, 1000) - 2990) <= 1.5);
+    }
+}
+
+TEST_CASE("Polynomial energy calibration")
+{
+    CalibrationBackup backup({"gain_labrL", "poly_labrL"});
+
+    SUBCASE("The polynomial replaces gain and shift"){
+        std::ostringstream poly;
+        poly << "gain_labrL = 5 5 5 5 5 5\npoly_labrL =";
+        for ( int i = 0 ; i < NUM_LABR_3X8_DETECTORS ; ++i )
+            poly << " 1 2 0.01 " << ( ( i == 1 ) ? 0.0001 : 0 );
+        REQUIRE(LoadCalibration(poly.str()));
+
+        // E(100) = 1 + 200 + 100 + 100, with a slope of 7 keV/ch at x = 100.
+        for ( int n = 0 ; n < 100 ; ++n ){
+            CHECK(std::abs(Energy(labr_3x8, 0, 100) - 301) <= 2);
+            CHECK(std::abs(Energy(labr_3x8, 1, 100) - 401) <= 3.5);
+        }
+    }
+
+    SUBCASE("Gain and shift are used when the polynomial doesn't fit the channels"){
+        REQUIRE(LoadCalibration("gain_labrL = 5 5 5 5 5 5\npoly_labrL = 1 2 3"));
+        CHECK(std::abs(Energy(labr_3x8, 0, 100) - 500) <= 2.5);
+    }
+}
+
+TEST_CASE("Time-walk correction")
+{
+    CalibrationBackup backup({"walk_t_labrF", "shift_t_labrF"});
+    const double t0 = Time(labr_2x2_fs, 0, 100);
+
+    SUBCASE("The walk is subtracted from the time"){
+        REQUIRE(LoadCalibration("walk_t_labrF = 2 100 0 0"));
+        CHECK(Time(labr_2x2_fs, 0, 100) == doctest::Approx(t0 - 3).epsilon(1e-6));
+        CHECK(Time(labr_2x2_fs, 0, 400) == doctest::Approx(t0 - 2.25).epsilon(1e-6));
+    }
+
+    SUBCASE("Linear walk and offset of the raw energy"){
+        REQUIRE(LoadCalibration("walk_t_labrF = 0 50 -50 0.01"));
+        CHECK(Time(labr_2x2_fs, 0, 100) == doctest::Approx(t0 - 2).epsilon(1e-6));
+
+        // No 1/x term at or below the offset.
+        CHECK(Time(labr_2x2_fs, 0, 50) == doctest::Approx(t0 - 0.5).epsilon(1e-6));
+    }
+
+    SUBCASE("The walk is shared by the detectors of a type and removed when zero"){
+        REQUIRE(LoadCalibration("walk_t_labrF = 2 100 0 0"));
+        CHECK(Time(labr_2x2_fs, 1, 100) == doctest::Approx(t0 - 3).epsilon(1e-6));
+        REQUIRE(LoadCalibration("walk_t_labrF = 0 0 0 0"));
+        CHECK(Time(labr_2x2_fs, 0, 100) == doctest::Approx(t0));
+    }
+
+    SUBCASE("The time shift is added"){
+        REQUIRE(LoadCalibration("shift_t_labrF = 1.5 0 0 0 0 0"));
+        CHECK(Time(labr_2x2_fs, 0, 100) == doctest::Approx(t0 + 1.5));
+    }
+}
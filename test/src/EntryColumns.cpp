@@ -0,0 +1,101 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Event/EntryColumns.h>
+
+#include <doctest/doctest.h>
+
+#include <TBranch.h>
+#include <TTree.h>
+
+using namespace Event;
+
+// Local copy, the static member can't be bound to a reference without a definition.
+static const int inline_capacity = EntryColumns::inline_capacity;
+
+//! Fill an entry with values derived from its index.
+static void FillEntry(EntryColumns &columns, const int &n)
+{
+    columns.ID[n] = uint16_t(n);
+    columns.e_raw[n] = uint16_t(10*n);
+    columns.energy[n] = 1.5*n;
+    columns.tfine[n] = 0.25*n;
+    columns.tcoarse[n] = 1000*int64_t(n);
+    columns.cfdvalid[n] = ( n % 2 == 0 );
+}
+
+//! Check the entries filled by FillEntry.
+static void CheckEntries(const EntryColumns &columns, const int &mult)
+{
+    REQUIRE(columns.mult == mult);
+    for ( int n = 0 ; n < mult ; ++n ){
+        CHECK(columns.ID[n] == n);
+        CHECK(columns.e_raw[n] == 10*n);
+        CHECK(columns.energy[n] == 1.5*n);
+        CHECK(columns.tfine[n] == 0.25*n);
+        CHECK(columns.tcoarse[n] == 1000*int64_t(n));
+        CHECK(columns.cfdvalid[n] == ( n % 2 == 0 ));
+    }
+}
+
+TEST_CASE("Entries are kept when the storage grows past the inline capacity")
+{
+    const int mult = 3*inline_capacity + 1;
+    EntryColumns columns;
+    CHECK(columns.GetCapacity() == inline_capacity);
+
+    for ( int n = 0 ; n < mult ; ++n )
+        FillEntry(columns, columns.Next());
+    CHECK(columns.GetCapacity() >= mult);
+    CheckEntries(columns, mult);
+
+    SUBCASE("The storage is reused when reset"){
+        const int capacity = columns.GetCapacity();
+        const double *energy = columns.energy;
+        columns.mult = 0;
+        for ( int n = 0 ; n < mult ; ++n )
+            FillEntry(columns, columns.Next());
+        CHECK(columns.GetCapacity() == capacity);
+        CHECK(columns.energy == energy);
+        CheckEntries(columns, mult);
+    }
+
+    SUBCASE("Copy beyond the inline capacity"){
+        EntryColumns copy(columns);
+        CHECK(copy.energy != columns.energy);
+        CheckEntries(copy, mult);
+    }
+
+    SUBCASE("Assign beyond the inline capacity"){
+        EntryColumns copy;
+        FillEntry(copy, copy.Next());
+        copy = columns;
+        CHECK(copy.GetCapacity() >= mult);
+        CheckEntries(copy, mult);
+
+        EntryColumns small;
+        FillEntry(small, small.Next());
+        copy = small;
+        CheckEntries(copy, 1);
+    }
+}
+
+TEST_CASE("Branches follow the columns when the storage grows")
+{
+    TTree tree("test", "test");
+    EntryColumns columns;
+    TBranch *id = tree.Branch("ID", columns.ID, "ID[mult]/s");
+    TBranch *energy = tree.Branch("energy", columns.energy, "energy[mult]/D");
+    TBranch *tcoarse = tree.Branch("tcoarse", columns.tcoarse, "tcoarse[mult]/L");
+    columns.SetBranch(EntryColumns::col_ID, id);
+    columns.SetBranch(EntryColumns::col_energy, energy);
+    columns.SetBranch(EntryColumns::col_tcoarse, tcoarse);
+
+    for ( int n = 0 ; n < inline_capacity + 1 ; ++n )
+        FillEntry(columns, columns.Next());
+
+    CHECK(id->GetAddress() == reinterpret_cast<char *>(columns.ID));
+    CHECK(energy->GetAddress() == reinterpret_cast<char *>(columns.energy));
+    CHECK(tcoarse->GetAddress() == reinterpret_cast<char *>(columns.tcoarse));
+}
@@ -0,0 +1,163 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Event/EventBuilder.h>
+#include <Event/TriggerCondition.h>
+
+#include "TestEntries.h"
+
+#include <doctest/doctest.h>
+
+#include <limits>
+#include <vector>
+
+using namespace Event;
+
+TEST_CASE("Event window edges around the trigger")
+{
+    // An entry exactly one window from the trigger is outside the event.
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(labr_3x8, 0, -500),
+        MakeEntry(labr_3x8, 1, -499),
+        MakeEntry(eDet, 0, 1000),
+        MakeEntry(labr_3x8, 2, 2499),
+        MakeEntry(labr_3x8, 3, 2500)
+    };
+    EventBuilder builder(eDet, 1500);
+    std::vector<EventRange> events;
+    CHECK(builder.BuildEvents(entries.data(), entries.size(), events) == entries.size());
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].begin == 1);
+    CHECK(events[0].end == 4);
+}
+
+TEST_CASE("Event window uses the CFD correction")
+{
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(labr_3x8, 0, -500),
+        MakeEntry(eDet, 0, 1000)
+    };
+    entries[0].cfdcorr = 0.5;
+    EventBuilder builder(eDet, 1500);
+    std::vector<EventRange> events;
+    builder.BuildEvents(entries.data(), entries.size(), events);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].begin == 0);
+}
+
+TEST_CASE("Entries are only part of a single event")
+{
+    // The second trigger is inside the window of the first.
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(eDet, 0, 0),
+        MakeEntry(eDet, 1, 100),
+        MakeEntry(labr_3x8, 0, 1550),
+        MakeEntry(eDet, 2, 5000),
+        MakeEntry(labr_3x8, 1, 5100)
+    };
+    EventBuilder builder(eDet, 1500);
+    std::vector<EventRange> events;
+    builder.BuildEvents(entries.data(), entries.size(), events);
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].begin == 0);
+    CHECK(events[0].end == 2);
+    CHECK(events[1].begin == 3);
+    CHECK(events[1].end == 5);
+}
+
+TEST_CASE("Events extending past the last entry are kept when not flushing")
+{
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(labr_3x8, 0, 0),
+        MakeEntry(eDet, 0, 10000),
+        MakeEntry(labr_3x8, 1, 10100)
+    };
+    EventBuilder builder(eDet, 1500);
+    std::vector<EventRange> events;
+    CHECK(builder.BuildEvents(entries.data(), entries.size(), events, false) == 1);
+    CHECK(events.empty());
+    CHECK(builder.BuildEvents(entries.data(), entries.size(), events, true) == entries.size());
+    CHECK(events.size() == 1);
+}
+
+TEST_CASE("Event window without length never moves past the trigger")
+{
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(labr_3x8, 0, 0),
+        MakeEntry(eDet, 0, 100),
+        MakeEntry(labr_3x8, 1, 200)
+    };
+    for ( double window : {0., -10., std::numeric_limits<double>::quiet_NaN()} ){
+        EventBuilder builder(eDet, window);
+        std::vector<EventRange> events;
+        builder.BuildEvents(entries.data(), entries.size(), events);
+        REQUIRE(events.size() == 1);
+        CHECK(events[0].begin <= 1);
+        CHECK(events[0].end == 2);
+    }
+}
+
+TEST_CASE("Events not fulfilling the condition are dropped")
+{
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(eDet, 0, 0),
+        MakeEntry(labr_3x8, 0, 10),
+        MakeEntry(eDet, 1, 5000),
+        MakeEntry(clover, 0, 5010)
+    };
+    TriggerCondition condition("labr_3x8");
+    EventBuilder builder(eDet, 1500, &condition);
+    std::vector<EventRange> events;
+    builder.BuildEvents(entries.data(), entries.size(), events);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].begin == 0);
+    CHECK(events[0].end == 2);
+}
+
+TEST_CASE("Windows without a trigger")
+{
+    std::vector<Parser::Entry_t> entries = {
+        MakeEntry(labr_3x8, 0, 0),
+        MakeEntry(labr_3x8, 1, 1499),
+        MakeEntry(labr_3x8, 2, 1500),
+        MakeEntry(labr_3x8, 3, 2000),
+        MakeEntry(labr_3x8, 4, 5000)
+    };
+    EventBuilder builder(any, 1500);
+    std::vector<EventRange> events;
+
+    SUBCASE("Fixed length windows"){
+        builder.BuildWindows(entries.data(), entries.size(), events, fixed_window);
+        REQUIRE(events.size() == 3);
+        CHECK(events[0].begin == 0);
+        CHECK(events[0].end == 2);
+        CHECK(events[1].begin == 2);
+        CHECK(events[1].end == 4);
+        CHECK(events[2].begin == 4);
+        CHECK(events[2].end == 5);
+    }
+
+    SUBCASE("Windows closed by gaps"){
+        builder.BuildWindows(entries.data(), entries.size(), events, gap_window);
+        REQUIRE(events.size() == 2);
+        CHECK(events[0].begin == 0);
+        CHECK(events[0].end == 4);
+        CHECK(events[1].begin == 4);
+        CHECK(events[1].end == 5);
+    }
+
+    SUBCASE("A gap of exactly one window closes the window"){
+        builder.BuildWindows(entries.data() + 3, 2, events, gap_window);
+        CHECK(events.size() == 2);
+        events.clear();
+        std::vector<Parser::Entry_t> pair = {MakeEntry(labr_3x8, 0, 0), MakeEntry(labr_3x8, 1, 1500)};
+        builder.BuildWindows(pair.data(), pair.size(), events, gap_window);
+        CHECK(events.size() == 2);
+    }
+
+    SUBCASE("No entries"){
+        builder.BuildWindows(entries.data(), 0, events, gap_window);
+        CHECK(events.empty());
+    }
+}
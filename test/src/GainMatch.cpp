@@ -0,0 +1,78 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Parameters/GainMatch.h>
+
+#include "TestEntries.h"
+#include "TestParameters.h"
+
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <vector>
+
+//! Add entries forming a Gaussian peak in the raw energy of a detector.
+static void AddPeak(std::vector<Parser::Entry_t> &entries, const DetectorType &type, const int &num,
+                    const double &mean, const double &sigma, const double &area)
+{
+    Parser::Entry_t entry = MakeEntry(type, num, 0);
+    for ( int adc = int(mean - 5*sigma) ; adc <= int(mean + 5*sigma) ; ++adc ){
+        const int n = int(std::round(area*std::exp(-0.5*std::pow((adc - mean)/sigma, 2))/(sigma*std::sqrt(2*M_PI))));
+        entry.adcdata = uint16_t(adc);
+        entries.insert(entries.end(), n, entry);
+    }
+}
+
+TEST_CASE("Gain match to known source lines")
+{
+    CalibrationBackup backup({"gain_labrF", "shift_labrF"});
+
+    // Channel 0 has gain 0.5 keV/ch and shift 10 keV, channel 2 gain 0.25 keV/ch and no shift.
+    std::vector<Parser::Entry_t> entries;
+    AddPeak(entries, labr_2x2_fs, 0, (661.7 - 10)/0.5, 4, 5000);
+    AddPeak(entries, labr_2x2_fs, 0, (1332.5 - 10)/0.5, 6, 3000);
+    AddPeak(entries, labr_2x2_fs, 2, 661.7/0.25, 8, 5000);
+    AddPeak(entries, labr_2x2_fs, 2, 1332.5/0.25, 12, 3000);
+
+    GainMatch gainmatch({1332.5, 661.7});
+    gainmatch.Fill(entries);
+    CHECK(gainmatch.Solve() == 2);
+
+    Parameter *gain = GetCalibrationParameter("gain_labrF");
+    Parameter *shift = GetCalibrationParameter("shift_labrF");
+    CHECK(gain->Get(0) == doctest::Approx(0.5).epsilon(0.002));
+    CHECK(shift->Get(0) == doctest::Approx(10).epsilon(0.05));
+    CHECK(gain->Get(2) == doctest::Approx(0.25).epsilon(0.002));
+    CHECK(std::abs(shift->Get(2)) < 1);
+
+    // Channels without data are unchanged.
+    CHECK(gain->Get(1) == 1);
+    CHECK(shift->Get(1) == 0);
+}
+
+TEST_CASE("Gain match to a reference channel")
+{
+    CalibrationBackup backup({"gain_labrL", "shift_labrL"});
+
+    std::vector<Parser::Entry_t> entries;
+    AddPeak(entries, labr_3x8, 0, 1000, 5, 5000);
+    AddPeak(entries, labr_3x8, 0, 3000, 8, 3000);
+    AddPeak(entries, labr_3x8, 1, 500, 4, 5000);
+    AddPeak(entries, labr_3x8, 1, 1500, 6, 3000);
+
+    SUBCASE("The other channels are matched to the reference"){
+        GainMatch gainmatch({}, 0);
+        gainmatch.Fill(entries);
+        CHECK(gainmatch.Solve() == 2);
+        Parameter *gain = GetCalibrationParameter("gain_labrL");
+        CHECK(gain->Get(0) == doctest::Approx(1).epsilon(0.002));
+        CHECK(gain->Get(1) == doctest::Approx(2).epsilon(0.002));
+    }
+
+    SUBCASE("Reference channels out of range are rejected"){
+        GainMatch gainmatch({}, NUM_LABR_3X8_DETECTORS);
+        gainmatch.Fill(entries);
+        CHECK(gainmatch.Solve() == 0);
+    }
+}
@@ -0,0 +1,89 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Utilities/HDF5_writer.h>
+
+#include "TestEntries.h"
+
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <vector>
+
+//! Read a column dataset written by the HDF5_Writer.
+template<typename T>
+static std::vector<T> ReadColumn(const hid_t &file, const char *name, const hid_t &mem_type)
+{
+    hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    REQUIRE(dset >= 0);
+    hid_t space = H5Dget_space(dset);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(space, dims, nullptr);
+    std::vector<T> values(dims[0]);
+    CHECK(H5Dread(dset, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()) >= 0);
+    H5Sclose(space);
+    H5Dclose(dset);
+    return values;
+}
+
+TEST_CASE("Entries written to HDF5 are read back unchanged")
+{
+    const char *fname = "test_hdf5_writer.h5";
+
+    // More than one chunk, such that the datasets are extended.
+    const size_t chunk_rows = HDF5_Writer::chunk_rows;
+    const size_t size = chunk_rows + 1000;
+    const uint16_t addresses[] = {FindAddress(labr_3x8, 1), FindAddress(clover, 2, 3), FindAddress(eDet, 5)};
+    std::vector<Parser::Entry_t> entries(size);
+    for ( size_t n = 0 ; n < size ; ++n ){
+        entries[n] = {addresses[n % 3], uint16_t(n % 16384), uint16_t(n % 1000), int64_t(n)*1000 - 5,
+                      0.125*(n % 7), 1.5*n, n % 5 == 0, n % 3 == 0};
+    }
+
+    {
+        HDF5_Writer writer(fname);
+        writer.Write(entries.data(), 1000);
+        writer.Write(entries.data() + 1000, size - 1000);
+        CHECK(writer.GetRows() == chunk_rows);
+    }
+
+    hid_t file = H5Fopen(fname, H5F_ACC_RDONLY, H5P_DEFAULT);
+    REQUIRE(file >= 0);
+    auto dtype = ReadColumn<uint16_t>(file, "data/dtype", H5T_NATIVE_UINT16);
+    auto id = ReadColumn<int16_t>(file, "data/id", H5T_NATIVE_INT16);
+    auto adcdata = ReadColumn<uint16_t>(file, "data/adcdata", H5T_NATIVE_UINT16);
+    auto cfddata = ReadColumn<uint16_t>(file, "data/cfddata", H5T_NATIVE_UINT16);
+    auto timestamp = ReadColumn<int64_t>(file, "data/timestamp", H5T_NATIVE_INT64);
+    auto cfdcorr = ReadColumn<double>(file, "data/cfdcorr", H5T_NATIVE_DOUBLE);
+    auto energy = ReadColumn<double>(file, "data/energy", H5T_NATIVE_DOUBLE);
+    auto cfdfail = ReadColumn<uint8_t>(file, "data/cfdfail", H5T_NATIVE_UINT8);
+    auto finishcode = ReadColumn<uint8_t>(file, "data/finishcode", H5T_NATIVE_UINT8);
+
+    // The detector ID's are signed, as returned by GetFlatID.
+    hid_t dset = H5Dopen(file, "data/id", H5P_DEFAULT);
+    hid_t type = H5Dget_type(dset);
+    CHECK(H5Tget_sign(type) == H5T_SGN_2);
+    H5Tclose(type);
+    H5Dclose(dset);
+    H5Fclose(file);
+    std::remove(fname);
+
+    REQUIRE(dtype.size() == size);
+    REQUIRE(finishcode.size() == size);
+    int mismatch = 0;
+    for ( size_t n = 0 ; n < size ; ++n ){
+        const Parser::Entry_t &entry = entries[n];
+        mismatch += dtype[n] != GetDetectorType(entry.address);
+        mismatch += id[n] != GetFlatID(entry.address);
+        mismatch += adcdata[n] != entry.adcdata;
+        mismatch += cfddata[n] != entry.cfddata;
+        mismatch += timestamp[n] != entry.timestamp;
+        mismatch += cfdcorr[n] != entry.cfdcorr;
+        mismatch += energy[n] != entry.energy;
+        mismatch += bool(cfdfail[n]) != entry.cfdfail;
+        mismatch += bool(finishcode[n]) != entry.finishcode;
+    }
+    CHECK(mismatch == 0);
+    CHECK(id[1] == 2*NUM_CLOVER_CRYSTALS + 3);
+}
@@ -0,0 +1,53 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Utilities/Histogram.h>
+
+#include <doctest/doctest.h>
+
+#include <limits>
+#include <numeric>
+
+TEST_CASE("Entries are filled in the bin of their value")
+{
+    Histogram2D hist(10, 0, 100, 2, 0, 20);
+    hist.Fill(5, 0);
+    hist.Fill(99.9, 1);
+    hist.FillXY(10, 15);
+    hist.FillBin(3, 0);
+    CHECK(hist.GetBinContent(0, 0) == 1);
+    CHECK(hist.GetBinContent(9, 1) == 1);
+    CHECK(hist.GetBinContent(1, 1) == 1);
+    CHECK(hist.GetBinContent(3, 0) == 1);
+}
+
+TEST_CASE("Entries outside the range are ignored")
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Histogram2D hist(10, 0, 100, 2, 0, 20);
+    hist.Fill(-0.1, 0);
+    hist.Fill(100, 0);
+    hist.Fill(nan, 0);
+    hist.Fill(50, 2);
+    hist.FillXY(50, 20);
+    hist.FillXY(50, -1);
+    hist.FillXY(nan, 10);
+    hist.FillXY(50, nan);
+    hist.FillBin(10, 0);
+    const uint32_t *first = hist.GetRow(0);
+    CHECK(std::accumulate(first, first + 2*hist.GetXbins(), 0u) == 0);
+}
+
+TEST_CASE("Values just below the upper edge never round up past the last bin")
+{
+    // (x - xmin)*xbins/(xmax - xmin) rounds up to xbins for this x < xmax.
+    const int xbins = 14068;
+    const double xmin = -6732.2857142857147, xmax = 3202.7142857142853, x = 3202.7142857142849;
+    REQUIRE(x < xmax);
+    Histogram2D hist(xbins, xmin, xmax, 2, 0, 2);
+    CHECK(hist.FindXbin(x) < xbins);
+    hist.Fill(x, 0);
+    hist.FillXY(x, 0.5);
+    CHECK(hist.GetBinContent(0, 1) == 0);
+}
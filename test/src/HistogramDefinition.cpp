@@ -0,0 +1,65 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <RootInterface/HistogramDefinition.h>
+
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+//! Read histogram definitions from text.
+static std::vector<HistogramDefinition> ReadText(const std::string &text)
+{
+    const char *fname = "test_histograms.ini";
+    std::ofstream(fname) << text;
+    try {
+        auto definitions = ReadHistograms(fname);
+        std::remove(fname);
+        return definitions;
+    } catch ( ... ){
+        std::remove(fname);
+        throw;
+    }
+}
+
+TEST_CASE("Histograms are defined in the order of the file")
+{
+    auto definitions = ReadText("[time_labrL]\n"
+                                "detector = labr_3x8\n"
+                                "axis = time\n"
+                                "reference = labr_2x2_fs 1\n"
+                                "xbins = 3000\nxmin = -1500\nxmax = 1500\n"
+                                "[energy_clover]\n"
+                                "Detector = clover\n"
+                                "gate = 100 5000\n"
+                                "xbins = 1000\nxmin = 0\nxmax = 10000\n"
+                                "[a_ring]\n"
+                                "detector = de_ring\n"
+                                "axis = e_raw\n"
+                                "xbins = 100\nxmin = 0\nxmax = 16384\n");
+    REQUIRE(definitions.size() == 3);
+    CHECK(definitions[0].name == "time_labrL");
+    CHECK(definitions[0].axis == HistogramDefinition::axis_time);
+    CHECK(definitions[0].reference_id == 1);
+    CHECK(definitions[1].name == "energy_clover");
+    CHECK(definitions[1].detector == clover);
+    CHECK(definitions[1].gate_low == 100);
+    CHECK(definitions[1].gate_high == 5000);
+    CHECK(definitions[2].name == "a_ring");
+    CHECK(definitions[2].xbins == 100);
+}
+
+TEST_CASE("Invalid histogram definitions are rejected")
+{
+    const std::string binning = "xbins = 100\nxmin = 0\nxmax = 100\n";
+    CHECK_THROWS_AS(ReadText("[e]\ndetector = clover\ngates = 100 200\n" + binning), std::runtime_error);
+    CHECK_THROWS_AS(ReadText("[e]\ndetector = clovers\n" + binning), std::runtime_error);
+    CHECK_THROWS_AS(ReadText("[e]\ndetector = clover\naxis = tof\n" + binning), std::runtime_error);
+    CHECK_THROWS_AS(ReadText("[e]\ndetector = clover\ngate = 200 100\n" + binning), std::runtime_error);
+    CHECK_THROWS_AS(ReadText("[e]\ndetector = clover\nxbins = 0\n"), std::runtime_error);
+    CHECK_THROWS_AS(ReadHistograms("no_such_file.ini"), std::runtime_error);
+}
@@ -0,0 +1,84 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Parameters/PeakFinder.h>
+
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <vector>
+
+//! Add a Gaussian peak to a spectrum.
+static void AddPeak(std::vector<uint32_t> &counts, const double &xmin, const double &width,
+                    const double &mean, const double &sigma, const double &area)
+{
+    for ( size_t i = 0 ; i < counts.size() ; ++i ){
+        const double x = xmin + (i + 0.5)*width;
+        counts[i] += uint32_t(std::round(area*width*std::exp(-0.5*std::pow((x - mean)/sigma, 2))/(sigma*std::sqrt(2*M_PI))));
+    }
+}
+
+TEST_CASE("Find a single peak")
+{
+    std::vector<uint32_t> counts(1000, 0);
+    AddPeak(counts, -100, 0.5, 50, 3, 10000);
+    Peak_t peak = {0, 0, 0};
+
+    SUBCASE("Without background"){
+        REQUIRE(FindPeak(counts.data(), int(counts.size()), -100, 0.5, peak));
+        CHECK(peak.centroid == doctest::Approx(50).epsilon(0.001));
+        CHECK(peak.fwhm == doctest::Approx(2.355*3).epsilon(0.1));
+        CHECK(peak.area == doctest::Approx(10000).epsilon(0.05));
+    }
+
+    SUBCASE("On a flat background"){
+        for ( auto &c : counts )
+            c += 20;
+        REQUIRE(FindPeak(counts.data(), int(counts.size()), -100, 0.5, peak));
+        CHECK(peak.centroid == doctest::Approx(50).epsilon(0.001));
+        CHECK(peak.area == doctest::Approx(10000).epsilon(0.05));
+    }
+
+    SUBCASE("Peaks below the minimum area are ignored"){
+        CHECK_FALSE(FindPeak(counts.data(), int(counts.size()), -100, 0.5, peak, 20000));
+    }
+}
+
+TEST_CASE("No peak in an empty spectrum")
+{
+    std::vector<uint32_t> counts(100, 0);
+    Peak_t peak = {0, 0, 0};
+    CHECK_FALSE(FindPeak(counts.data(), int(counts.size()), 0, 1, peak));
+    CHECK_FALSE(FindPeak(counts.data(), 0, 0, 1, peak));
+    CHECK(FindPeaks(counts.data(), int(counts.size()), 0, 1, &peak, 1) == 0);
+}
+
+TEST_CASE("Find several peaks")
+{
+    std::vector<uint32_t> counts(4096, 0);
+    AddPeak(counts, 0, 1, 50, 5, 50000);    // Noise near threshold
+    AddPeak(counts, 0, 1, 2000, 8, 5000);
+    AddPeak(counts, 0, 1, 1000, 6, 10000);
+    AddPeak(counts, 0, 1, 3000, 10, 2000);
+    Peak_t peaks[4];
+
+    SUBCASE("Peaks are sorted by centroid"){
+        REQUIRE(FindPeaks(counts.data(), int(counts.size()), 0, 1, peaks, 4) == 4);
+        CHECK(peaks[0].centroid == doctest::Approx(50).epsilon(0.01));
+        CHECK(peaks[1].centroid == doctest::Approx(1000).epsilon(0.001));
+        CHECK(peaks[2].centroid == doctest::Approx(2000).epsilon(0.001));
+        CHECK(peaks[3].centroid == doctest::Approx(3000).epsilon(0.001));
+    }
+
+    SUBCASE("The most prominent peaks are found first"){
+        REQUIRE(FindPeaks(counts.data(), int(counts.size()), 0, 1, peaks, 2, 100) == 2);
+        CHECK(peaks[0].centroid == doctest::Approx(1000).epsilon(0.001));
+        CHECK(peaks[1].centroid == doctest::Approx(2000).epsilon(0.001));
+    }
+
+    SUBCASE("Bins below the first bin are ignored"){
+        CHECK(FindPeaks(counts.data(), int(counts.size()), 0, 1, peaks, 4, 100) == 3);
+        CHECK(FindPeaks(counts.data(), int(counts.size()), 0, 1, peaks, 4, 5000) == 0);
+    }
+}
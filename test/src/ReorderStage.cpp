@@ -0,0 +1,105 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Utilities/ReorderStage.h>
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//! Make a chunk with a given sequence number and number of events.
+static Event::EventChunk MakeChunk(const uint64_t &sequence, const uint32_t &events=1)
+{
+    Event::EventChunk chunk;
+    chunk.sequence = sequence;
+    for ( uint32_t n = 0 ; n < events ; ++n )
+        chunk.events.push_back({n, n+1});
+    return chunk;
+}
+
+TEST_CASE("Chunks pushed out of order are forwarded in order")
+{
+    Chunk_queue_t queue;
+    ReorderStage reorder(&queue, 8);
+
+    CHECK(reorder.Push(MakeChunk(2)));
+    CHECK(reorder.Push(MakeChunk(1)));
+    CHECK(reorder.Pending() == 2);
+    CHECK(queue.size_approx() == 0);
+
+    CHECK(reorder.Push(MakeChunk(0)));
+    CHECK(reorder.Pending() == 0);
+    REQUIRE(queue.size_approx() == 3);
+
+    Event::EventChunk chunk;
+    for ( uint64_t sequence = 0 ; sequence < 3 ; ++sequence ){
+        REQUIRE(queue.try_dequeue(chunk));
+        CHECK(chunk.sequence == sequence);
+    }
+}
+
+TEST_CASE("Chunks without events are not forwarded")
+{
+    Chunk_queue_t queue;
+    ReorderStage reorder(&queue, 8);
+
+    reorder.Push(MakeChunk(1));
+    reorder.Push(MakeChunk(0, 0));
+    reorder.Push(MakeChunk(2, 0));
+    REQUIRE(queue.size_approx() == 1);
+
+    Event::EventChunk chunk;
+    REQUIRE(queue.try_dequeue(chunk));
+    CHECK(chunk.sequence == 1);
+    CHECK(reorder.Pending() == 0);
+}
+
+TEST_CASE("Chunks too far ahead are blocked until the earlier chunks arrive")
+{
+    Chunk_queue_t queue;
+    ReorderStage reorder(&queue, 2);
+    std::atomic<bool> done(false);
+
+    reorder.Push(MakeChunk(1));
+    std::thread pusher([&reorder, &done](){
+        reorder.Push(MakeChunk(2));
+        done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK_FALSE(done);
+    CHECK(reorder.Pending() == 1);
+
+    reorder.Push(MakeChunk(0));
+    pusher.join();
+    CHECK(done);
+    CHECK(reorder.Pending() == 0);
+
+    Event::EventChunk chunk;
+    for ( uint64_t sequence = 0 ; sequence < 3 ; ++sequence ){
+        REQUIRE(queue.try_dequeue(chunk));
+        CHECK(chunk.sequence == sequence);
+    }
+}
+
+TEST_CASE("Aborting releases blocked threads")
+{
+    Chunk_queue_t queue;
+    ReorderStage reorder(&queue, 1);
+    std::atomic<bool> result(true);
+
+    std::thread pusher([&reorder, &result](){
+        result = reorder.Push(MakeChunk(5));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reorder.Abort();
+    pusher.join();
+    CHECK_FALSE(result);
+    CHECK(reorder.Aborted());
+    CHECK_FALSE(reorder.Push(MakeChunk(0)));
+    CHECK(queue.size_approx() == 0);
+}
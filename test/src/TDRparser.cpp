@@ -6,11 +6,11 @@
 #include <Parser/Parser.h>
 #include <Parser/TDRparser.h>
 
-#include <catch.hpp>
+#include <doctest/doctest.h>
 
 using namespace Parser;
 
-TEST_CASE("Test of the TDR parser", "[TDRparser]")
+TEST_CASE("Test of the TDR parser")
 {
     TDRparser parser;
 
@@ -0,0 +1,31 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef TESTENTRIES_H
+#define TESTENTRIES_H
+
+#include <Parser/Entry.h>
+#include <Parameters/experimentsetup.h>
+
+#include <stdexcept>
+
+//! Get the address of a detector in the address map.
+inline uint16_t FindAddress(const DetectorType &type, const int &num=0, const int &tel=-1)
+{
+    for ( uint16_t address = 0 ; address < TOTAL_NUMBER_OF_ADDRESSES ; ++address ){
+        const DetectorInfo_t dinfo = GetDetector(address);
+        if ( dinfo.type == type && dinfo.detectorNum == num && ( tel < 0 || dinfo.telNum == tel ) )
+            return address;
+    }
+    throw std::invalid_argument("No such detector in the address map");
+}
+
+//! Make an entry of a detector at a given time.
+inline Parser::Entry_t MakeEntry(const DetectorType &type, const int &num, const int64_t &timestamp,
+                                 const double &energy=0)
+{
+    return {FindAddress(type, num), 0, 0, timestamp, 0., energy, false, false};
+}
+
+#endif // TESTENTRIES_H
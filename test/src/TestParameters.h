@@ -0,0 +1,66 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#ifndef TESTPARAMETERS_H
+#define TESTPARAMETERS_H
+
+#include <Parameters/Calibration.h>
+#include <Parameters/Parameters.h>
+
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Load calibration parameters from text, in the same format as the calibration files.
+inline bool LoadCalibration(const std::string &text)
+{
+    const char *fname = "test_calibration.txt";
+    std::ofstream(fname) << text << std::endl;
+    const bool ok = SetCalibration(fname);
+    std::remove(fname);
+    return ok;
+}
+
+/*!
+ * The calibration parameters are global, the parameters changed by a test
+ * are saved when constructed and restored when going out of scope.
+ */
+class CalibrationBackup {
+
+private:
+
+    //! Parameters and their saved values.
+    std::vector<std::pair<Parameter *, std::vector<Parameter::param_t>>> saved;
+
+public:
+
+    //! Save the values of the named parameters.
+    CalibrationBackup(std::initializer_list<const char *> names)
+    {
+        for ( auto name : names ){
+            Parameter *param = GetCalibrationParameter(name);
+            if ( !param )
+                throw std::invalid_argument(std::string("No calibration parameter '") + name + "'");
+            std::vector<Parameter::param_t> values(param->GetSize());
+            for ( int i = 0 ; i < param->GetSize() ; ++i )
+                values[i] = param->Get(i);
+            saved.emplace_back(param, values);
+        }
+    }
+
+    //! Restore the saved values and rebuild the calibration tables.
+    ~CalibrationBackup()
+    {
+        for ( auto &param : saved )
+            param.first->Set(param.second);
+        LoadCalibration("");
+    }
+
+};
+
+#endif // TESTPARAMETERS_H
@@ -0,0 +1,79 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Parameters/TimeAlignment.h>
+
+#include "TestEntries.h"
+#include "TestParameters.h"
+
+#include <doctest/doctest.h>
+
+#include <stdexcept>
+#include <vector>
+
+//! Make time ordered pairs of a reference entry and a delayed entry of another detector.
+static std::vector<Parser::Entry_t> MakePairs(const DetectorType &ref_type, const int &ref_num,
+                                              const DetectorType &type, const int &num,
+                                              const double &delay, const int &pairs=200)
+{
+    std::vector<Parser::Entry_t> entries;
+    for ( int n = 0 ; n < pairs ; ++n ){
+        const int64_t time = 10000*int64_t(n + 1);
+        entries.push_back(MakeEntry(ref_type, ref_num, time));
+        entries.push_back(MakeEntry(type, num, time + int64_t(delay)));
+        entries.back().cfdcorr = delay - int64_t(delay);
+    }
+    return entries;
+}
+
+TEST_CASE("Prompt peaks are moved to zero")
+{
+    CalibrationBackup backup({"shift_t_labrL"});
+    GetCalibrationParameter("shift_t_labrL")->Set(1, 5.);
+
+    std::vector<Parser::Entry_t> entries = MakePairs(labr_2x2_fs, 0, labr_3x8, 1, 25.3);
+    TimeAlignment alignment;
+    alignment.Fill(entries);
+    CHECK(alignment.Solve() == 1);
+
+    CHECK(GetCalibrationParameter("shift_t_labrL")->Get(1) == doctest::Approx(5 - 25.3).epsilon(0.005));
+    CHECK(GetCalibrationParameter("shift_t_labrL")->Get(0) == 0);
+}
+
+TEST_CASE("Entries outside the window are not aligned")
+{
+    CalibrationBackup backup({"shift_t_labrL"});
+
+    std::vector<Parser::Entry_t> entries = MakePairs(labr_2x2_fs, 0, labr_3x8, 1, 2000);
+    TimeAlignment alignment(1500);
+    alignment.Fill(entries);
+    CHECK(alignment.Solve() == 0);
+    CHECK(GetCalibrationParameter("shift_t_labrL")->Get(1) == 0);
+}
+
+TEST_CASE("Time alignment to another reference detector")
+{
+    CalibrationBackup backup({"shift_t_labrF", "shift_t_labrL"});
+
+    std::vector<Parser::Entry_t> entries = MakePairs(labr_3x8, 2, labr_2x2_fs, 0, -40);
+
+    SUBCASE("The given reference is used"){
+        TimeAlignment alignment(1500, labr_3x8, 2);
+        alignment.Fill(entries);
+        CHECK(alignment.Solve() == 1);
+        CHECK(GetCalibrationParameter("shift_t_labrF")->Get(0) == doctest::Approx(40).epsilon(0.005));
+    }
+
+    SUBCASE("Fails without entries from the reference"){
+        TimeAlignment alignment(1500, labr_3x8, 3);
+        alignment.Fill(entries);
+        CHECK_THROWS_AS(alignment.Solve(), std::runtime_error);
+    }
+
+    SUBCASE("Fails with the default reference"){
+        TimeAlignment alignment;
+        alignment.Fill(MakePairs(labr_3x8, 2, labr_3x8, 1, 10));
+        CHECK_THROWS_AS(alignment.Solve(), std::runtime_error);
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Created by Vetle Wegner Ingeberg on 19/10/2026.
+//
+
+#include <Event/TriggerCondition.h>
+
+#include "TestEntries.h"
+
+#include <doctest/doctest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Event;
+
+static bool Accept(const TriggerCondition &condition, const std::vector<Parser::Entry_t> &entries)
+{
+    return condition.Accept(entries.data(), entries.data() + entries.size());
+}
+
+TEST_CASE("Trigger condition of a single detector type")
+{
+    TriggerCondition condition("de_ring");
+    CHECK(condition.GetNumTerms() == 1);
+    CHECK(Accept(condition, {MakeEntry(de_ring, 0, 0)}));
+    CHECK(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(de_ring, 3, 10)}));
+    CHECK_FALSE(Accept(condition, {MakeEntry(labr_3x8, 0, 0)}));
+    CHECK_FALSE(Accept(condition, {}));
+}
+
+TEST_CASE("Trigger condition with and, or and parentheses")
+{
+    TriggerCondition condition("de_ring & (labr_3x8 | clover>=2)");
+    CHECK(condition.GetNumTerms() == 2);
+    CHECK(Accept(condition, {MakeEntry(de_ring, 0, 0), MakeEntry(labr_3x8, 1, 5)}));
+    CHECK(Accept(condition, {MakeEntry(de_ring, 0, 0), MakeEntry(clover, 1, 5), MakeEntry(clover, 2, 6)}));
+    CHECK_FALSE(Accept(condition, {MakeEntry(de_ring, 0, 0), MakeEntry(clover, 1, 5)}));
+    CHECK_FALSE(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(clover, 1, 5), MakeEntry(clover, 2, 6)}));
+}
+
+TEST_CASE("Trigger condition multiplicities")
+{
+    SUBCASE("At least"){
+        TriggerCondition condition("labr_3x8>=2");
+        CHECK_FALSE(Accept(condition, {MakeEntry(labr_3x8, 0, 0)}));
+        CHECK(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(labr_3x8, 1, 1)}));
+    }
+    SUBCASE("More than"){
+        TriggerCondition condition("labr_3x8>2");
+        CHECK_FALSE(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(labr_3x8, 1, 1)}));
+        CHECK(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(labr_3x8, 1, 1), MakeEntry(labr_3x8, 2, 2)}));
+    }
+    SUBCASE("Same type in both operands of and"){
+        TriggerCondition condition("clover & clover>=3");
+        CHECK(condition.GetNumTerms() == 1);
+        CHECK_FALSE(Accept(condition, {MakeEntry(clover, 0, 0), MakeEntry(clover, 1, 1)}));
+        CHECK(Accept(condition, {MakeEntry(clover, 0, 0), MakeEntry(clover, 1, 1), MakeEntry(clover, 2, 2)}));
+    }
+}
+
+TEST_CASE("Trigger condition is expanded to disjunctive normal form")
+{
+    // (a | b) & (c | d) gives the four terms ac, ad, bc and bd.
+    TriggerCondition condition("(de_ring | de_sect) & (labr_3x8 | clover)");
+    CHECK(condition.GetNumTerms() == 4);
+    CHECK(Accept(condition, {MakeEntry(de_sect, 0, 0), MakeEntry(clover, 0, 1)}));
+    CHECK_FALSE(Accept(condition, {MakeEntry(de_sect, 0, 0), MakeEntry(de_ring, 0, 1)}));
+
+    // Terms requiring more than an other term are removed.
+    CHECK(TriggerCondition("de_ring | de_ring & labr_3x8").GetNumTerms() == 1);
+    CHECK(TriggerCondition("clover>=2 | clover>=3").GetNumTerms() == 1);
+    CHECK(TriggerCondition("eDet | eDet").GetNumTerms() == 1);
+}
+
+TEST_CASE("Trigger condition names are case insensitive and spaces are ignored")
+{
+    TriggerCondition condition("  LABR_3X8&( eDet |rfchan ) ");
+    CHECK(Accept(condition, {MakeEntry(labr_3x8, 0, 0), MakeEntry(rfchan, 0, 1)}));
+    CHECK(condition.GetExpression() == "  LABR_3X8&( eDet |rfchan ) ");
+}
+
+TEST_CASE("Malformed trigger conditions are rejected")
+{
+    CHECK_THROWS_AS(TriggerCondition(""), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("labr"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("any"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("de_ring &"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("de_ring | | clover"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("(de_ring & clover"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("de_ring)"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("clover>="), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("clover>=x"), std::invalid_argument);
+    CHECK_THROWS_AS(TriggerCondition("de_ring clover"), std::invalid_argument);
+}
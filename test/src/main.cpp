@@ -2,5 +2,5 @@
 // Created by Vetle Wegner Ingeberg on 01/10/2019.
 //
 
-#define CATCH_CONFIG_MAIN
-#include <catch.hpp>
\ No newline at end of file
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>